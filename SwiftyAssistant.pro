@@ -37,12 +37,13 @@ RESOURCES += \
     src/res/res.qrc \
     trad.qrc
 
+include(src/swiftyengine.pri)
+
 HEADERS += \
-    src/engine.h \
-    src/plugininterface.h \
+    src/qmlcomponentcache.h \
     src/swiftyworker.h
 
 SOURCES += \
-    src/engine.cpp \
     src/main.cpp \
+    src/qmlcomponentcache.cpp \
     src/swiftyworker.cpp
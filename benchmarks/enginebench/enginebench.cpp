@@ -0,0 +1,320 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+
+#include "engine.h"
+#include "syntheticplugin.h"
+#include "allocationstats.h"
+#include "perfresults.h"
+
+/**
+ * The results written to SWIFTY_BENCH_RESULTS at the end of the benchmarks
+ */
+static PerfResults results;
+
+/**
+ * Measure the code again outside of QBENCHMARK to print the time and the allocations per call
+ */
+template <typename Function>
+static void report(Function function)
+{
+    QElapsedTimer timer;
+    AllocationStats::Counters allocations = AllocationStats::thread();
+    qint64 iterations = 0;
+
+    timer.start();
+
+    do {
+        function();
+        iterations++;
+    } while (timer.elapsed() < 200);
+
+    qint64 nsecs = timer.nsecsElapsed();
+    allocations = AllocationStats::thread() - allocations;
+
+    qInfo("%s(%s): %.0f ns/op, %s", QTest::currentTestFunction(), QTest::currentDataTag(),
+          double(nsecs) / iterations, qPrintable(AllocationStats::describe(allocations, iterations)));
+
+    const QString name = QString("bench.%1.%2.").arg(QTest::currentTestFunction(), QTest::currentDataTag());
+    results.add(name+"time", double(nsecs) / iterations, "ns");
+    results.add(name+"allocs", double(allocations.totalCount()) / iterations, "allocs");
+    results.add(name+"bytes", double(allocations.totalBytes()) / iterations, "bytes");
+}
+
+#define BENCHMARK(code) \
+    QBENCHMARK { code; } \
+    report([&]() { code; })
+
+/**
+ * Benchmarks of the engine with synthetic plugins.
+ *
+ * The sizes are given by SWIFTY_BENCH_SIZES, "5x20,20x100" by default:
+ * 5 plugins of 20 items, then 20 plugins of 100 items.
+ * SWIFTY_BENCH_RESULTS=<file> writes the results for tools/perfbaseline.
+ */
+class EngineBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void format_data();
+    void format();
+    void readVarInText_data();
+    void readVarInText();
+    void formatAction_data();
+    void formatAction();
+    void textChanged_data();
+    void textChanged();
+    void matchKeywords_data();
+    void matchKeywords();
+    void understand_data();
+    void understand();
+    void understandCached_data();
+    void understandCached();
+    void analizePlugin_data();
+    void analizePlugin();
+
+private:
+    struct Fixture
+    {
+        Engine *engine = nullptr;
+        QList<SyntheticPlugin *> plugins;
+    };
+
+    void addSizes();
+    Fixture &fixture();
+
+    QTemporaryDir home;
+    QMap<QString, Fixture> fixtures;
+};
+
+void EngineBenchmark::initTestCase()
+{
+    QVERIFY(home.isValid());
+
+    // The engine loads the plugins of ~/SwiftyPlugins and writes its settings in the home folder
+    qputenv("HOME", home.path().toLocal8Bit());
+}
+
+void EngineBenchmark::cleanupTestCase()
+{
+    foreach (Fixture fixture , fixtures) {
+        delete fixture.engine;
+        qDeleteAll(fixture.plugins);
+    }
+
+    const QString fileName = qEnvironmentVariable("SWIFTY_BENCH_RESULTS");
+    if (fileName.isEmpty()) return;
+
+    qint64 rss = PerfResults::peakRss();
+    if (rss >= 0) results.add("bench.peak_rss", rss, "bytes");
+
+    QVERIFY(results.save(fileName));
+}
+
+void EngineBenchmark::addSizes()
+{
+    QTest::addColumn<int>("plugins");
+    QTest::addColumn<int>("items");
+
+    QString sizes = qEnvironmentVariable("SWIFTY_BENCH_SIZES", "5x20,20x100");
+
+    foreach (QString size , sizes.split(',', Qt::SkipEmptyParts)) {
+        QList<QString> values = size.split('x');
+        if (values.length() != 2) continue;
+
+        QTest::newRow(qPrintable(size)) << values.at(0).toInt() << values.at(1).toInt();
+    }
+}
+
+/**
+ * @return the engine and the plugins of the actual size, created at the first use
+ */
+EngineBenchmark::Fixture &EngineBenchmark::fixture()
+{
+    QFETCH(int, plugins);
+    QFETCH(int, items);
+
+    const QString key = QString::number(plugins)+"x"+QString::number(items);
+
+    if (!fixtures.contains(key)) {
+        Fixture fixture;
+        fixture.engine = new Engine;
+
+        for (int i = 0; i < plugins; i++) {
+            SyntheticPlugin *plugin = new SyntheticPlugin(i, items);
+            fixture.plugins.append(plugin);
+            fixture.engine->addPlugin(plugin);
+        }
+
+        fixtures.insert(key, fixture);
+    }
+
+    return fixtures[key];
+}
+
+void EngineBenchmark::format_data()
+{
+    addSizes();
+}
+
+void EngineBenchmark::format()
+{
+    Engine *engine = fixture().engine;
+    const QString text = "Bonjour, peux-tu mettre la musique & éteindre la lumière du salon ?";
+
+    BENCHMARK(engine->format(text));
+}
+
+void EngineBenchmark::readVarInText_data()
+{
+    addSizes();
+}
+
+void EngineBenchmark::readVarInText()
+{
+    Engine *engine = fixture().engine;
+    const QList<QString> var = QList<QString>() << "mets la musique" << "rouge vert";
+    const QString text = "Réponse pour ?1 le ?date à ?hour, vous avez dit : ?0";
+
+    BENCHMARK(engine->readVarInText(text, var));
+}
+
+void EngineBenchmark::formatAction_data()
+{
+    addSizes();
+}
+
+void EngineBenchmark::formatAction()
+{
+    Engine *engine = fixture().engine;
+    const QString action = "web_message with_action_btn search la meteo de demain";
+
+    BENCHMARK(engine->formatAction(action));
+}
+
+void EngineBenchmark::textChanged_data()
+{
+    addSizes();
+}
+
+void EngineBenchmark::textChanged()
+{
+    Fixture &current = fixture();
+    Engine *engine = current.engine;
+    const QString command = current.plugins.last()->command(0);
+
+    // The user types the proposition of a plugin, then the main propositions are shown again
+    BENCHMARK(
+        for (int i = 1; i <= command.length(); i++) engine->textChanged(command.left(i));
+        engine->addBaseProp()
+    );
+}
+
+void EngineBenchmark::matchKeywords_data()
+{
+    addSizes();
+}
+
+void EngineBenchmark::matchKeywords()
+{
+    Fixture &current = fixture();
+    Engine *engine = current.engine;
+    QFETCH(int, items);
+
+    // The last item of the last plugin: all the items are checked before it
+    const QList<QString> cmd = engine->format(current.plugins.last()->command(items-1)).first();
+
+    QVERIFY(engine->matchAllPlugins(cmd).isValid());
+    BENCHMARK(engine->matchAllPlugins(cmd));
+}
+
+void EngineBenchmark::understand_data()
+{
+    addSizes();
+}
+
+void EngineBenchmark::understand()
+{
+    Fixture &current = fixture();
+    Engine *engine = current.engine;
+    QFETCH(int, items);
+
+    const QString text = current.plugins.at(current.plugins.length()/2)->command(items/2);
+
+    // The whole path: the command is matched again by the rules at each iteration
+    QCOMPARE(engine->understand(text).value(0).pluginId, current.plugins.at(current.plugins.length()/2)->pluginId());
+    BENCHMARK(engine->matchCache.clear(); engine->understand(text));
+}
+
+void EngineBenchmark::understandCached_data()
+{
+    addSizes();
+}
+
+void EngineBenchmark::understandCached()
+{
+    Fixture &current = fixture();
+    Engine *engine = current.engine;
+    QFETCH(int, items);
+
+    const QString text = current.plugins.at(current.plugins.length()/2)->command(items/2);
+
+    // The command is found in the match cache after the first call
+    QCOMPARE(engine->understand(text).value(0).pluginId, current.plugins.at(current.plugins.length()/2)->pluginId());
+    BENCHMARK(engine->understand(text));
+}
+
+void EngineBenchmark::analizePlugin_data()
+{
+    addSizes();
+}
+
+void EngineBenchmark::analizePlugin()
+{
+    Fixture &current = fixture();
+    Engine *engine = current.engine;
+    QFETCH(int, items);
+
+    SyntheticPlugin *plugin = current.plugins.last();
+    const QList<QList<QString>> array_cmd = engine->format(plugin->followUp(items-1));
+    QList<CommandResult> results;
+
+    // A conversation is in progress with the last item, its actions are not executed
+    engine->conversation->nextReplyPluginName = plugin->pluginId();
+    engine->conversation->nextReplyItemId = plugin->itemId(items-1);
+    engine->conversation->nextReplyNeedId = plugin->childId(items-1);
+    engine->recording = &results;
+
+    QVERIFY(engine->analizePlugin(array_cmd, array_cmd.first()));
+    BENCHMARK(engine->analizePlugin(array_cmd, array_cmd.first()); results.clear());
+
+    engine->recording = nullptr;
+    engine->conversation->nextReplyPluginName.clear();
+    engine->conversation->nextReplyItemId.clear();
+    engine->conversation->nextReplyNeedId.clear();
+}
+
+QTEST_GUILESS_MAIN(EngineBenchmark)
+
+#include "enginebench.moc"
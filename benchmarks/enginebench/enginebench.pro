@@ -0,0 +1,44 @@
+#   Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+#	
+#   Copyright (C) <2021>  <SwiftApp>
+#
+#   This program is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   This program is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+# Benchmarks of the engine: qmake benchmarks/enginebench/enginebench.pro && make && ./enginebench
+# The time of each benchmark is printed by QBENCHMARK, followed by a line with ns/op, allocs/op and
+# the allocations by stage of the engine.
+
+QT += testlib
+QT -= gui
+
+CONFIG += console
+CONFIG -= app_bundle
+
+TARGET = enginebench
+
+# The allocations are counted, not written in the log by each request
+CONFIG += alloc_counters
+
+include(../../src/swiftyengine.pri)
+
+INCLUDEPATH += ../../tools/synthetic
+
+HEADERS += \
+    syntheticplugin.h \
+    ../../tools/synthetic/syntheticxml.h
+
+SOURCES += \
+    enginebench.cpp \
+    syntheticplugin.cpp \
+    ../../tools/synthetic/syntheticxml.cpp
@@ -0,0 +1,96 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "syntheticplugin.h"
+
+/**
+ * Generate the xml of the plugin
+ *
+ * @param index the number of the plugin, used in its id and its words
+ * @param items the number of <Item> elements
+ */
+SyntheticPlugin::SyntheticPlugin(int index, int items, QObject *parent) : QObject(parent), generator(spec(index, items))
+{
+    xml = generator.xml();
+    commands = generator.commands();
+}
+
+QString SyntheticPlugin::getDataXml() const
+{
+    return xml;
+}
+
+QString SyntheticPlugin::pluginId() const
+{
+    return generator.pluginId();
+}
+
+void SyntheticPlugin::execAction(const QList<QString> &cmd)
+{
+    Q_UNUSED(cmd)
+}
+
+QList<QString> SyntheticPlugin::getCommande() const
+{
+    return commands;
+}
+
+QObject* SyntheticPlugin::getObject()
+{
+    return this;
+}
+
+void SyntheticPlugin::messageReceived(const QString &message, const QString &pluginId)
+{
+    Q_UNUSED(message)
+    Q_UNUSED(pluginId)
+}
+
+QString SyntheticPlugin::command(int item) const
+{
+    return generator.command(item);
+}
+
+QString SyntheticPlugin::followUp(int item) const
+{
+    return generator.followUp(item);
+}
+
+QString SyntheticPlugin::itemId(int item) const
+{
+    return generator.itemId(item);
+}
+
+QString SyntheticPlugin::childId(int item) const
+{
+    return generator.childId(item);
+}
+
+/**
+ * Every item has a <Var> and no <condition>, all the items are proposed by getCommande()
+ */
+SyntheticSpec SyntheticPlugin::spec(int index, int items)
+{
+    SyntheticSpec spec;
+    spec.plugin = index;
+    spec.items = items;
+    spec.varDensity = 1;
+    spec.conditionDensity = 0;
+    spec.commands = items;
+
+    return spec;
+}
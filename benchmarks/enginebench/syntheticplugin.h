@@ -0,0 +1,68 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#ifndef SYNTHETICPLUGIN_H
+#define SYNTHETICPLUGIN_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+
+#include "plugininterface.h"
+#include "syntheticxml.h"
+
+/**
+ * A plugin serving the xml of SyntheticXml, each item has two groups of
+ * three keywords and a <Var>
+ */
+class SyntheticPlugin : public QObject, public PluginInterfaceV2
+{
+    Q_OBJECT
+    Q_INTERFACES(PluginInterfaceV2)
+
+public:
+    SyntheticPlugin(int index, int items, QObject *parent = nullptr);
+
+    QString getDataXml() const override;
+    QString pluginId() const override;
+    void execAction(const QList<QString> &cmd) override;
+    QList<QString> getCommande() const override;
+    QObject* getObject() override;
+
+    QString command(int item) const;
+    QString followUp(int item) const;
+    QString itemId(int item) const;
+    QString childId(int item) const;
+
+signals:
+    void sendMessage(QString reply, bool isFin, QString typeMessage, QString id, QList<QString> url = QList<QString>(), QList<QString> textUrl = QList<QString>());
+    void sendMessageToQml(QString message);
+    void showQml(QString qml, QString id);
+    void execAction(QString action);
+
+public slots:
+    void messageReceived(const QString &message, const QString &pluginId) override;
+
+private:
+    static SyntheticSpec spec(int index, int items);
+
+    SyntheticXml generator;
+    QString xml;
+    QList<QString> commands;
+};
+
+#endif // SYNTHETICPLUGIN_H
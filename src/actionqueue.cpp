@@ -0,0 +1,112 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "actionqueue.h"
+
+/**
+ * Called before the actions of an item are added, the actions of two items are never in the same batch
+ */
+void ActionQueue::beginItem()
+{
+    currentItem++;
+}
+
+void ActionQueue::append(const PendingAction &action)
+{
+    pending.append(action);
+    pending.last().item = currentItem;
+}
+
+bool ActionQueue::isEmpty() const
+{
+    return pending.isEmpty();
+}
+
+/**
+ * Remove the actions not executed yet, called when the plugins are loaded again
+ */
+void ActionQueue::clear()
+{
+    pending.clear();
+}
+
+/**
+ * Remove all the actions from the queue
+ *
+ * @return the actions grouped by batch, in the order they were added
+ */
+QList<QList<PendingAction>> ActionQueue::takeBatches()
+{
+    QList<QList<PendingAction>> batches;
+
+    foreach (PendingAction action , pending) {
+        if (!batches.isEmpty() && !action.isEngineAction()) {
+            const PendingAction &last = batches.last().last();
+
+            if (last.plugin == action.plugin && last.item == action.item) {
+                batches.last().append(action);
+                continue;
+            }
+        }
+
+        batches.append(QList<PendingAction>() << action);
+    }
+
+    pending.clear();
+
+    return batches;
+}
+
+/**
+ * Add the execution time of an action executed alone
+ *
+ * @param verb the plugin id and the first word of the action
+ * @param nsecs the execution time in nanoseconds
+ */
+void ActionQueue::record(const QString &verb, qint64 nsecs)
+{
+    ActionTiming &timing = timingByVerb[verb];
+    timing.count++;
+    timing.totalNsecs += nsecs;
+    timing.maxNsecs = qMax(timing.maxNsecs, nsecs);
+}
+
+/**
+ * Add the execution time of a batch, the time of each of its actions is not known
+ *
+ * @param pluginId the plugin id
+ * @param actions the number of actions of the batch
+ * @param nsecs the execution time of the call in nanoseconds
+ */
+void ActionQueue::recordBatch(const QString &pluginId, int actions, qint64 nsecs)
+{
+    BatchTiming &timing = timingByPlugin[pluginId];
+    timing.count++;
+    timing.actions += actions;
+    timing.totalNsecs += nsecs;
+    timing.maxNsecs = qMax(timing.maxNsecs, nsecs);
+}
+
+QHash<QString, ActionTiming> ActionQueue::timings() const
+{
+    return timingByVerb;
+}
+
+QHash<QString, BatchTiming> ActionQueue::batchTimings() const
+{
+    return timingByPlugin;
+}
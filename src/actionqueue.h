@@ -0,0 +1,92 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#ifndef ACTIONQUEUE_H
+#define ACTIONQUEUE_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QVariantMap>
+
+#include "plugininterface.h"
+
+/**
+ * An action of an item given to a plugin, executed after the replies of the request are sent
+ */
+struct PendingAction
+{
+    PluginInterfaceV2 *plugin = nullptr;
+    QList<QString> cmd;
+    QList<QString> var;
+    QHash<QString, QString> namedVar;
+    QVariantMap slotValues;
+    quint64 item = 0; // the execution of the item which gave the action, see ActionQueue::beginItem
+
+    bool isEngineAction() const { return plugin == nullptr; } // executed by the action table: a host action of a plugin
+};
+
+/**
+ * Execution time of the actions with the same verb
+ */
+struct ActionTiming
+{
+    quint64 count = 0;
+    qint64 totalNsecs = 0;
+    qint64 maxNsecs = 0;
+};
+
+/**
+ * Execution time of the batches given to a plugin, each one is a single execActions() call
+ */
+struct BatchTiming
+{
+    quint64 count = 0;
+    quint64 actions = 0;
+    qint64 totalNsecs = 0;
+    qint64 maxNsecs = 0;
+};
+
+/**
+ * Queue of the calls to the plugins found while a request is analized, the actions
+ * of the engine itself are executed when they are found.
+ *
+ * The host actions of the plugins are executed one by one, the consecutive actions
+ * of one execution of an item given to its plugin form one batch.
+ */
+class ActionQueue
+{
+public:
+    void beginItem();
+    void append(const PendingAction &action);
+    bool isEmpty() const;
+    void clear();
+    QList<QList<PendingAction>> takeBatches();
+
+    void record(const QString &verb, qint64 nsecs);
+    void recordBatch(const QString &pluginId, int actions, qint64 nsecs);
+    QHash<QString, ActionTiming> timings() const;
+    QHash<QString, BatchTiming> batchTimings() const;
+
+private:
+    QList<PendingAction> pending;
+    quint64 currentItem = 0;
+    QHash<QString, ActionTiming> timingByVerb;
+    QHash<QString, BatchTiming> timingByPlugin;
+};
+
+#endif // ACTIONQUEUE_H
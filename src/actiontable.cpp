@@ -0,0 +1,211 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "actiontable.h"
+
+#include <QtGlobal>
+
+/**
+ * @return if the words of the path are the first words of the action
+ */
+static bool isPrefix(const QList<QString> &path, const QList<QString> &cmd)
+{
+    if (path.length() > cmd.length()) return false;
+
+    for (int i = 0; i < path.length(); i++) {
+        if (path.at(i) != cmd.at(i)) return false;
+    }
+
+    return true;
+}
+
+/**
+ * Continue the hash of a verb path with a word
+ *
+ * @param word the word
+ * @param h the hash of the previous words and the separator
+ * @return the same value as the compile time hash for an ascii word
+ */
+quint32 ActionTable::hash(const QString &word, quint32 h)
+{
+    for (const QChar &ch : word)
+        h = (h ^ ch.unicode()) * Prime;
+
+    return h;
+}
+
+/**
+ * Register an action
+ *
+ * @param pathHash the hash of the path, given by ACTION_PATH
+ * @param path the words of the action before its arguments, "app notify"
+ * @param handler the function called with the arguments of the action
+ * @param flags the options of the action ("-t", "-c"...), the words after a flag are its value
+ * @param owner the plugin which registered the action, empty for the engine
+ * @return false if the path is already used or if its hash is already used by another path
+ */
+bool ActionTable::add(quint32 pathHash, const QString &path, const ActionHandler &handler, const QList<QString> &flags, const QString &owner)
+{
+    const QList<QString> words = path.split(' ', Qt::SkipEmptyParts);
+    quint32 h = Seed;
+
+    for (int i = 0; i < words.length(); i++) {
+        if (i > 0) h = (h ^ quint32(' ')) * Prime;
+        h = hash(words.at(i), h);
+    }
+
+    if (words.isEmpty() || h != pathHash) {
+        qWarning("Action %s: invalid path", qPrintable(path));
+        return false;
+    }
+
+    h = Seed;
+
+    for (int i = 0; i < words.length(); i++) {
+        if (i > 0) h = (h ^ quint32(' ')) * Prime;
+        h = hash(words.at(i), h);
+
+        const QList<QString> prefix = words.mid(0, i+1);
+        auto entry = entries.find(h);
+
+        if (entry != entries.end() && entry->path != prefix) {
+            qWarning("Action %s: hash collision with %s", qPrintable(path), qPrintable(entry->path.join(" ")));
+            return false;
+        }
+
+        if (i < words.length()-1) {
+            // The namespace of an action of the engine, the other actions of a plugin stay with the plugin
+            if (entry == entries.end() && owner.isEmpty()) {
+                Entry space;
+                space.path = prefix;
+                space.owner = owner;
+                entries.insert(h, space);
+            }
+        }
+        else if (entry != entries.end() && entry->handler) {
+            qWarning("Action %s: already registered", qPrintable(path));
+            return false;
+        }
+        else {
+            Entry action;
+            action.path = prefix;
+            action.flags = flags;
+            action.owner = owner;
+            action.handler = handler;
+            entries.insert(h, action);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Remove the actions registered by a plugin
+ *
+ * @param owner the plugin id
+ */
+void ActionTable::removeOwner(const QString &owner)
+{
+    auto entry = entries.begin();
+
+    while (entry != entries.end()) {
+        if (entry->owner == owner) entry = entries.erase(entry);
+        else ++entry;
+    }
+}
+
+/**
+ * Execute an action
+ *
+ * @param cmd the words of the action
+ * @return false if the action is not registered
+ */
+bool ActionTable::exec(const QList<QString> &cmd) const
+{
+    const Entry *entry = find(cmd);
+    if (entry == nullptr) return false;
+
+    if (entry->handler) entry->handler(parse(cmd, *entry));
+
+    return true;
+}
+
+/**
+ * @param cmd the words of the action
+ * @return if the action is registered, without executing it
+ */
+bool ActionTable::contains(const QList<QString> &cmd) const
+{
+    return find(cmd) != nullptr;
+}
+
+/**
+ * @param cmd the words of the action
+ * @return the plugin which registered the action, empty for an action of the engine or an unknown action
+ */
+QString ActionTable::owner(const QList<QString> &cmd) const
+{
+    const Entry *entry = find(cmd);
+
+    return entry != nullptr ? entry->owner : QString();
+}
+
+/**
+ * Find the longest registered path at the beginning of the action
+ */
+const ActionTable::Entry *ActionTable::find(const QList<QString> &cmd) const
+{
+    const Entry *found = nullptr;
+    quint32 h = Seed;
+
+    for (int i = 0; i < cmd.length(); i++) {
+        if (i > 0) h = (h ^ quint32(' ')) * Prime;
+        h = hash(cmd.at(i), h);
+
+        // "media pause" of a plugin has no "media" namespace, so a missing prefix does not stop the search
+        auto entry = entries.constFind(h);
+        if (entry != entries.constEnd() && isPrefix(entry->path, cmd)) found = &entry.value();
+    }
+
+    return found;
+}
+
+/**
+ * Split the arguments of an action: the words following a flag are its value, the others are in words
+ */
+ActionArgs ActionTable::parse(const QList<QString> &cmd, const Entry &entry)
+{
+    ActionArgs args;
+    args.command = cmd;
+    QString flag;
+
+    for (int i = entry.path.length(); i < cmd.length(); i++) {
+        if (entry.flags.contains(cmd.at(i))) {
+            flag = cmd.at(i);
+            args.options.insert(flag, QString());
+        }
+        else if (!flag.isEmpty()) {
+            QString &value = args.options[flag];
+            value.isEmpty() ? value.append(cmd.at(i)) : value.append(" "+cmd.at(i));
+        }
+        else {
+            args.words.append(cmd.at(i));
+        }
+    }
+
+    return args;
+}
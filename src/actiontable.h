@@ -0,0 +1,91 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#ifndef ACTIONTABLE_H
+#define ACTIONTABLE_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <functional>
+#include <type_traits>
+
+/**
+ * The arguments of a built-in action, split once before the handler is called
+ */
+struct ActionArgs
+{
+    QList<QString> command;
+    QList<QString> words;
+    QHash<QString, QString> options;
+
+    QString at(int i) const { return words.value(i); }
+    QString text() const { return words.join(" "); }
+    QString option(const QString &flag) const { return options.value(flag); }
+};
+
+typedef std::function<void(const ActionArgs &args)> ActionHandler;
+
+/**
+ * Dispatch table of the actions executed by the engine ("settings name", "app notify"...).
+ *
+ * The words of the verb path are hashed with FNV-1a, at compile time for the built-in
+ * actions with ACTION_PATH. Two paths with the same hash are refused, so one lookup per
+ * word of the action is enough. Registering "app notify" also registers "app": an
+ * unknown verb under a namespace of the engine is still taken by the engine. The paths
+ * registered by a plugin (PluginInterfaceV2::hostActions) have no namespace, so the
+ * other actions of the plugin starting with the same word are still given to it.
+ */
+class ActionTable
+{
+public:
+    enum : quint32 { Seed = 2166136261u, Prime = 16777619u };
+
+    static constexpr quint32 hash(const char *path, quint32 h = Seed)
+    {
+        return *path ? hash(path+1, (h ^ quint8(*path)) * Prime) : h;
+    }
+    static quint32 hash(const QString &word, quint32 h = Seed);
+
+    bool add(quint32 pathHash, const QString &path, const ActionHandler &handler,
+             const QList<QString> &flags = QList<QString>(), const QString &owner = QString());
+    void removeOwner(const QString &owner);
+    bool exec(const QList<QString> &cmd) const;
+    bool contains(const QList<QString> &cmd) const;
+    QString owner(const QList<QString> &cmd) const;
+
+private:
+    struct Entry
+    {
+        QList<QString> path;
+        QList<QString> flags;
+        QString owner;
+        ActionHandler handler;
+    };
+
+    const Entry *find(const QList<QString> &cmd) const;
+    static ActionArgs parse(const QList<QString> &cmd, const Entry &entry);
+
+    QHash<quint32, Entry> entries;
+};
+
+/**
+ * Pass the hash of a verb path computed at compile time and the path itself to ActionTable::add
+ */
+#define ACTION_PATH(path) std::integral_constant<quint32, ActionTable::hash(path)>::value, QStringLiteral(path)
+
+#endif // ACTIONTABLE_H
@@ -0,0 +1,228 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "allocationstats.h"
+
+#include <QDebug>
+#include <QStringList>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static thread_local AllocationStats::Stage currentStage = AllocationStats::Other;
+static thread_local quint64 threadCount[AllocationStats::StageCount];
+static thread_local quint64 threadBytes[AllocationStats::StageCount];
+static std::atomic<quint64> totalCount[AllocationStats::StageCount];
+static std::atomic<quint64> totalBytes[AllocationStats::StageCount];
+
+static const char *stageNames[] = { "other", "format", "matching", "template", "plugin call", "signal" };
+
+//===================================================
+//====================== Hooks ======================
+//===================================================
+
+#ifdef SWIFTY_ALLOC_STATS
+
+static inline void account(size_t size)
+{
+    const int stage = currentStage;
+
+    threadCount[stage]++;
+    threadBytes[stage] += size;
+    totalCount[stage].fetch_add(1, std::memory_order_relaxed);
+    totalBytes[stage].fetch_add(size, std::memory_order_relaxed);
+}
+
+#ifdef __GLIBC__
+
+extern "C" {
+
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void __libc_free(void *ptr);
+
+void *malloc(size_t size)
+{
+    account(size);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    account(count * size);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    account(size);
+    return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr)
+{
+    __libc_free(ptr);
+}
+
+}
+
+#else
+
+void *operator new(std::size_t size)
+{
+    account(size);
+
+    if (void *ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+#endif
+
+#endif
+
+//===================================================
+//==================== Counters =====================
+//===================================================
+
+quint64 AllocationStats::Counters::totalCount() const
+{
+    quint64 total = 0;
+    for (int stage = 0; stage < StageCount; stage++) total += count[stage];
+
+    return total;
+}
+
+quint64 AllocationStats::Counters::totalBytes() const
+{
+    quint64 total = 0;
+    for (int stage = 0; stage < StageCount; stage++) total += bytes[stage];
+
+    return total;
+}
+
+AllocationStats::Counters AllocationStats::Counters::operator-(const Counters &other) const
+{
+    Counters difference;
+
+    for (int stage = 0; stage < StageCount; stage++) {
+        difference.count[stage] = count[stage] - other.count[stage];
+        difference.bytes[stage] = bytes[stage] - other.bytes[stage];
+    }
+
+    return difference;
+}
+
+/**
+ * @return if the allocations are counted by this build
+ */
+bool AllocationStats::isEnabled()
+{
+#ifdef SWIFTY_ALLOC_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @return the allocations made by the current thread since it started
+ */
+AllocationStats::Counters AllocationStats::thread()
+{
+    Counters counters;
+
+    for (int stage = 0; stage < StageCount; stage++) {
+        counters.count[stage] = threadCount[stage];
+        counters.bytes[stage] = threadBytes[stage];
+    }
+
+    return counters;
+}
+
+/**
+ * @return the allocations made by all the threads since the start of the process
+ */
+AllocationStats::Counters AllocationStats::total()
+{
+    Counters counters;
+
+    for (int stage = 0; stage < StageCount; stage++) {
+        counters.count[stage] = totalCount[stage].load(std::memory_order_relaxed);
+        counters.bytes[stage] = totalBytes[stage].load(std::memory_order_relaxed);
+    }
+
+    return counters;
+}
+
+/**
+ * Attribute the next allocations of the current thread to a stage
+ *
+ * @return the previous stage, given to leave()
+ */
+AllocationStats::Stage AllocationStats::enter(Stage stage)
+{
+    Stage previous = currentStage;
+    currentStage = stage;
+
+    return previous;
+}
+
+void AllocationStats::leave(Stage previous)
+{
+    currentStage = previous;
+}
+
+const char *AllocationStats::stageName(Stage stage)
+{
+    return stageNames[stage];
+}
+
+/**
+ * @param divisor the number of requests or iterations, to get the allocations of one of them
+ * @return "n allocs, n bytes (stage n/n bytes, ...)" with the stages which allocated
+ */
+QString AllocationStats::describe(const Counters &counters, double divisor)
+{
+    QStringList stages;
+
+    for (int stage = 0; stage < StageCount; stage++) {
+        if (counters.count[stage] == 0) continue;
+
+        stages.append(QString("%1 %2/%3 bytes").arg(stageNames[stage])
+                      .arg(counters.count[stage] / divisor, 0, 'f', 1).arg(counters.bytes[stage] / divisor, 0, 'f', 0));
+    }
+
+    return QString("%1 allocs, %2 bytes (%3)").arg(counters.totalCount() / divisor, 0, 'f', 1)
+            .arg(counters.totalBytes() / divisor, 0, 'f', 0).arg(stages.join(", "));
+}
+
+AllocationRequest::~AllocationRequest()
+{
+    qDebug("Allocations of %s: %s", name, qPrintable(AllocationStats::describe(AllocationStats::thread() - start)));
+}
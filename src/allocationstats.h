@@ -0,0 +1,99 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#ifndef ALLOCATIONSTATS_H
+#define ALLOCATIONSTATS_H
+
+#include <QString>
+#include <QtGlobal>
+
+/**
+ * Count the heap allocations and their bytes by stage of the engine.
+ *
+ * Only the builds made with CONFIG+=alloc_stats (SWIFTY_ALLOC_STATS) replace
+ * malloc, calloc and realloc (glibc) or operator new (other libraries); the
+ * counters stay at 0 otherwise. An allocation is attributed to the stage set
+ * by the innermost ALLOCATION_STAGE of its thread. ALLOCATION_REQUEST only writes
+ * in the log with CONFIG+=alloc_stats (SWIFTY_ALLOC_LOG), not with the counters
+ * alone of CONFIG+=alloc_counters used by the benchmarks.
+ */
+class AllocationStats
+{
+public:
+    enum Stage { Other, Format, Matching, Template, PluginCall, Signal, StageCount };
+
+    struct Counters
+    {
+        quint64 count[StageCount] = {};
+        quint64 bytes[StageCount] = {};
+
+        quint64 totalCount() const;
+        quint64 totalBytes() const;
+        Counters operator-(const Counters &other) const;
+    };
+
+    static bool isEnabled();
+    static Counters thread();
+    static Counters total();
+
+    static Stage enter(Stage stage);
+    static void leave(Stage previous);
+
+    static const char *stageName(Stage stage);
+    static QString describe(const Counters &counters, double divisor = 1);
+};
+
+/**
+ * The allocations of the current thread are attributed to a stage until the end of the scope
+ */
+class AllocationStageScope
+{
+public:
+    explicit AllocationStageScope(AllocationStats::Stage stage) : previous(AllocationStats::enter(stage)) {}
+    ~AllocationStageScope() { AllocationStats::leave(previous); }
+
+private:
+    AllocationStats::Stage previous;
+};
+
+/**
+ * Write the allocations of a request made by the current thread in the debug log at the end of the scope
+ */
+class AllocationRequest
+{
+public:
+    explicit AllocationRequest(const char *name) : name(name), start(AllocationStats::thread()) {}
+    ~AllocationRequest();
+
+private:
+    const char *name;
+    AllocationStats::Counters start;
+};
+
+#ifdef SWIFTY_ALLOC_STATS
+#define ALLOCATION_STAGE(stage) AllocationStageScope allocationStage(AllocationStats::stage)
+#else
+#define ALLOCATION_STAGE(stage)
+#endif
+
+#ifdef SWIFTY_ALLOC_LOG
+#define ALLOCATION_REQUEST(name) AllocationRequest allocationRequest(name)
+#else
+#define ALLOCATION_REQUEST(name)
+#endif
+
+#endif // ALLOCATIONSTATS_H
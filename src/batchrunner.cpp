@@ -0,0 +1,135 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "batchrunner.h"
+#include "engine.h"
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QSemaphore>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+
+/**
+ * Load the plugins once, the engines of the threads share them and their rules
+ *
+ * @param workers the number of engines analizing the lines in parallel
+ */
+BatchRunner::BatchRunner(int workers)
+{
+    source = new Engine;
+    source->setWorkerMode();
+
+    for (int i = 0; i < qMax(1, workers); i++) {
+        QThread *thread = new QThread;
+        Engine *engine = new Engine(source);
+
+        thread->setObjectName("engine "+QString::number(i));
+        engine->moveToThread(thread);
+        QObject::connect(thread, &QThread::finished, engine, &QObject::deleteLater);
+        thread->start();
+
+        threads.append(thread);
+        engines.append(engine);
+    }
+}
+
+BatchRunner::~BatchRunner()
+{
+    foreach (QThread *thread , threads) {
+        thread->quit();
+        thread->wait();
+    }
+
+    qDeleteAll(threads);
+    delete source;
+}
+
+/**
+ * Analize all the lines of the input, the empty lines are ignored
+ *
+ * @param input one utterance per line
+ * @param output one JSON object per utterance: {"line", "input", "results": [{"command", "plugin", "item", "itemId", "replies"}]}
+ * @return 0, the exit code of the batch mode
+ */
+int BatchRunner::run(QIODevice *input, QIODevice *output)
+{
+    QTextStream in(input);
+    in.setCodec("UTF-8");
+
+    int lineNumber = 0;
+
+    while (!in.atEnd()) {
+        QList<QString> lines;
+        QList<int> lineNumbers;
+
+        while (lines.length() < ChunkSize && !in.atEnd()) {
+            QString line = in.readLine().trimmed();
+            lineNumber++;
+
+            if (line.isEmpty()) continue;
+
+            lines.append(line);
+            lineNumbers.append(lineNumber);
+        }
+
+        QVector<QList<CommandResult>> results(lines.length());
+        QList<CommandResult> *resultData = results.data();
+        QSemaphore done;
+
+        // Engine i analizes the lines i, i+n, i+2n...
+        for (int w = 0; w < engines.length(); w++) {
+            Engine *engine = engines.at(w);
+            const int count = engines.length();
+
+            QMetaObject::invokeMethod(engine, [engine, w, count, &lines, resultData, &done]() {
+                for (int i = w; i < lines.length(); i += count)
+                    resultData[i] = engine->understand(lines.at(i));
+
+                done.release();
+            }, Qt::QueuedConnection);
+        }
+
+        done.acquire(engines.length());
+
+        for (int i = 0; i < lines.length(); i++) {
+            QJsonArray commands;
+
+            foreach (CommandResult result , results.at(i)) {
+                QJsonObject command;
+                command.insert("command", result.command);
+                command.insert("plugin", result.pluginId);
+                command.insert("item", result.item);
+                command.insert("itemId", result.itemId);
+                command.insert("replies", QJsonArray::fromStringList(QStringList(result.replies)));
+                commands.append(command);
+            }
+
+            QJsonObject object;
+            object.insert("line", lineNumbers.at(i));
+            object.insert("input", lines.at(i));
+            object.insert("results", commands);
+
+            output->write(QJsonDocument(object).toJson(QJsonDocument::Compact));
+            output->write("\n");
+        }
+    }
+
+    return 0;
+}
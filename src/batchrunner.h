@@ -0,0 +1,51 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include <QList>
+#include <QThread>
+#include <QIODevice>
+
+class Engine;
+
+/**
+ * Run the utterances of a file through the engine and write what it understood as JSON lines.
+ *
+ * The lines are shared between several engines, each one in its own thread, and
+ * are written in the order of the input. The engines are workers of one engine which
+ * loads the plugins, so the calls to the plugins are serialized, see Engine::pluginLock.
+ * The actions of the plugins are not executed.
+ */
+class BatchRunner
+{
+public:
+    enum { ChunkSize = 4096 };
+
+    explicit BatchRunner(int workers = 1);
+    ~BatchRunner();
+
+    int run(QIODevice *input, QIODevice *output);
+
+private:
+    Engine *source = nullptr;
+    QList<QThread *> threads;
+    QList<Engine *> engines;
+};
+
+#endif // BATCHRUNNER_H
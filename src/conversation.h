@@ -0,0 +1,65 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#ifndef CONVERSATION_H
+#define CONVERSATION_H
+
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QVariantMap>
+
+#include "matchcache.h"
+
+/**
+ * The state of a conversation with one user: the propositions, the variables of the
+ * item being executed, the item waiting for a follow-up and the text being typed.
+ *
+ * An engine serves one conversation at a time, its own by default or the one of a
+ * session of the daemon mode, see Engine::setConversation.
+ */
+struct Conversation
+{
+    QList<QString> prop;
+    QList<QString> main_prop;
+    QList<QString> mainVolatil_prop;
+    QList<QString> showedProp;
+    int removePropNuber = 0;
+    bool isGoogleSuggest = false;
+
+    QList<QString> var;
+    QHash<QString, QString> namedVar;
+    QVariantMap slotValues;
+
+    QString nextReplyPluginName = "";
+    QString nextReplyNeedId = "";
+    QString nextReplyItemId = "";
+
+    QString idOfActualPlugin = "";
+
+    quint64 requestId = 0;
+
+    // The key of the session of the daemon mode, the plugins send to it the signals of its calls
+    QString session;
+
+    QString speculativeInput;
+    QString speculativeText;
+    QList<QList<QString>> speculativeCommands;
+    QList<RuleMatch> speculativeMatches;
+};
+
+#endif // CONVERSATION_H
@@ -16,206 +16,377 @@
    along with this program.  If not, see <https://www.gnu.org/licenses/>. */
 
 #include "engine.h"
+#include "pluginrelay.h"
 
 #include <QFile>
-#include <QApplication>
 #include <QIODevice>
-#include <QTextStream>
 #include <QRandomGenerator64>
 #include <QDebug>
-#include <QDesktopServices>
 #include <QUrl>
 #include <QPluginLoader>
 #include <QDir>
 #include <QCoreApplication>
-#include <QMessageBox>
 #include <QDateTime>
-#include <QDesktopServices>
+#include <QElapsedTimer>
 
-Engine::Engine(QObject *parent) : QObject(parent)
+Engine::Engine(QObject *parent) : QObject(parent), speculationTimer(this)
 {
     scanPlugin();
 
     connect(&googleSuggestNetworkManager, &QNetworkAccessManager::finished, this, &Engine::handleNetworkData);
-}
 
-//===================================================
-//================ Private function =================
-//===================================================
+    registerActions();
 
-bool Engine::execAction(QList<QString> cmd)
+    speculationTimer.setSingleShot(true);
+    speculationTimer.setInterval(150);
+    connect(&speculationTimer, &QTimer::timeout, this, &Engine::speculate);
+}
+
+/**
+ * Create an engine which uses the plugins and the compiled rules of another one, they are
+ * not loaded again. The rules are only read, so the engines can run in different threads
+ * as long as the source engine does not scan the plugins again. Used by the daemon mode:
+ * the work done after a request (speculation, web suggestions) has no session to go to,
+ * so it is not done by this engine. The signals the plugins send after a request are
+ * given with the session of the call by pluginSignalAfterRequest.
+ *
+ * @param source the engine which has loaded the plugins, it must outlive this engine
+ */
+Engine::Engine(const Engine *source, QObject *parent) : QObject(parent), speculationTimer(this)
 {
-    if (cmd[0] == "settings") {
-        if (cmd[1] == "name") {
-            if (cmd[2] != "") {
-                QVariant variant = readVarInText(cmd[2], var);
-                settings.setValue(key_settings_name, variant.toString());
-            }
-        }
+    setWorkerMode();
+
+    listPlugins = source->listPlugins;
+    listRules = source->listRules;
+    spellCorrector = source->spellCorrector;
+    semanticIndex = source->semanticIndex;
+    pluginProp = source->pluginProp;
+    pluginMainProp = source->pluginMainProp;
+    ownConversation = newConversation();
+
+    foreach (PluginInterfaceV2 *plug , listPlugins) {
+        connectPlugin(plug);
+        registerPluginActions(plug);
+    }
 
-        else if (cmd[1] == "prop") {
-            if (cmd[2] != "") {
-                QVariant variant = readVarInText(cmd[2], var);
-                settings.setValue(key_settings_proposition, variant.toBool() ? true : false);
-            }
-        }
+    registerActions();
+    updateSettingsVar();
+}
 
-        else if (cmd[1] == "show") {
-            emit reponseSended("", true, "settings", QList<QString>(), QList<QString>());
-        }
-    }
+Engine::~Engine()
+{
+    qDeleteAll(listV1Adapters);
+}
 
-    else if (cmd[0] == "app") {
-        if (cmd[1] == "quit") {
-            QApplication::quit();
-        }
+/**
+ * @return the state of a new conversation: the propositions of the plugins and no item in progress
+ */
+Conversation Engine::newConversation() const
+{
+    Conversation conversation;
+    conversation.prop = pluginProp;
+    conversation.main_prop = pluginMainProp;
 
-        else if (cmd[1] == "hideWindow") {
-            emit hideWindow();
-        }
+    return conversation;
+}
 
-        else if (cmd[1] == "showWindow") {
-            emit showWindow();
-        }
+/**
+ * Serve the sessions of the daemon mode: the signals of the plugins go to the engine which called
+ * them, see PluginRelay, and the calls to the plugins are serialized with the other engines of the
+ * daemon. The actions of a request are run by the caller of the engine, see runActions.
+ * Set on the engines which share their plugins, including the one which loaded them.
+ */
+void Engine::setWorkerMode()
+{
+    isWorker = true;
+}
 
-        else if (cmd[1] == "home") {
-            emit showHomeScreen();
-        }
+/**
+ * Continue another conversation, the next requests read and change its state
+ *
+ * @param conversation the conversation, it must stay valid while it is used;
+ *                     nullptr for the conversation of the engine
+ */
+void Engine::setConversation(Conversation *conversation)
+{
+    this->conversation = conversation != nullptr ? conversation : &ownConversation;
+}
 
-        else if (cmd[1] == "previousPage") {
-            emit previousPage();
-        }
+/**
+ * @return the number of commands found in the match cache
+ */
+quint64 Engine::matchCacheHits() const
+{
+    return matchCache.hits();
+}
 
-        else if (cmd[1] == "notify") {
-            qDebug("Ok notify");
-            QString notifyTitle;
-            QString notifyText;
-            QString notifyAction;
-            bool t = false;
-            bool c = false;
-            bool a = false;
-
-            for (int i = 2; i < cmd.length(); i++) {
-                if (cmd[i] == "-t") {
-                    t = true;
-                    a = false;
-                    c = false;
-                }
-                else if (cmd[i] == "-c") {
-                    c = true;
-                    a = false;
-                    t = false;
-                }
-                else if (cmd[i] == "-a") {
-                    a = true;
-                    t = false;
-                    c = false;
-                }
-                else if (c) {
-                    notifyText.append(cmd[i]+" ");
-                }
-                else if (a) {
-                    notifyAction.append(cmd[i]+" ");
-                }
-                else if (t) {
-                    notifyTitle.append(cmd[i]+" ");
-                }
-            }
+/**
+ * @return the number of commands which had to be matched against all the rules
+ */
+quint64 Engine::matchCacheMisses() const
+{
+    return matchCache.misses();
+}
 
-            emit sendNotify(notifyTitle, notifyText, notifyAction);
-        }
+/**
+ * Analize a text and render the replies without executing the actions of the plugins.
+ * Each text starts a new conversation, used by the batch mode.
+ *
+ * @param text the user input
+ * @return the plugin, the item and the replies found for each command of the text
+ */
+QList<CommandResult> Engine::understand(const QString &text)
+{
+    ALLOCATION_REQUEST("understand");
+    QList<CommandResult> results;
+    RequestArena::Scope arenaScope(&arena);
+    QElapsedTimer timer;
+    timer.start();
 
-        else if (cmd[1] == "openLinkInDefaultBrowser") {
-            QDesktopServices::openUrl(QUrl(cmd[2]));
-        }
-    }
+    conversation->requestId++;
+    conversation->nextReplyPluginName.clear();
+    conversation->nextReplyNeedId.clear();
+    conversation->nextReplyItemId.clear();
 
-    else if (cmd[0] == "web_message") {
-        if (cmd[1] == "without_action_btn") {
-            if (cmd[2] == "search") {
-                if (cmd[3] != "") {
-                    QString search = "";
-                    for (int i = 3; i < cmd.length(); i++) {
-                        search.append(cmd.at(i));
-                        if (i != cmd.length()-1) search.append(" ");
-                    }
-                    readVarInText(search, var).replace(" ", "+");
+    recording = &results;
+    analize(format(text));
+    recording = nullptr;
 
-                    QString url = "https://www.duckduckgo.com/"+search;
+    perfStats.recordUtterance(timer.nsecsElapsed());
 
-                    emit reponseSended("", true, "web_without_action_btn", QList<QString>() << url, QList<QString>());
-                }
-            }
+    return results;
+}
 
-            else if (cmd[2] == "site") {
-                if (cmd[3] != "") {
-                    bool isUserEntry = true;
+/**
+ * @return the execution time of the actions executed alone by plugin id and verb
+ */
+QHash<QString, ActionTiming> Engine::actionTimings() const
+{
+    return actionQueue.timings();
+}
 
-                    for (int i = 0; i < cmd[2].length(); i++) {
-                        int nextIndex = 1 == cmd[2].length() ? i : i+1;
-                        int nextIndexB = 2 == cmd[2].length() ? i : i+2;
-                        int nextIndexC = 3 == cmd[2].length() ? i : i+3;
+/**
+ * @return the execution time of the batches of actions by plugin id
+ */
+QHash<QString, BatchTiming> Engine::batchTimings() const
+{
+    return actionQueue.batchTimings();
+}
 
-                        if (cmd[2].at(0) == 'h' && cmd[2].at(nextIndex) == 't' && cmd[2].at(nextIndexB) == 't' && cmd[2].at(nextIndexC) == 'p')
-                            isUserEntry = false;
-                    }
+/**
+ * @return the counters and the latency histograms, see PerfStats::toVariantMap, with the
+ *         hits and misses of the match cache in "matchCache" and the delays of the
+ *         event loops in "eventLoops", see LagMonitor::statistics
+ */
+QVariantMap Engine::statistics() const
+{
+    QVariantMap stats = perfStats.toVariantMap();
+    stats.insert("eventLoops", LagMonitor::statistics());
 
-                    if (isUserEntry) emit reponseSended("", true, "web_without_action_btn", QList<QString>() << QUrl::fromUserInput(readVarInText(cmd[3], var)).toString(), QList<QString>());
-                    else emit reponseSended("", true, "web_without_action_btn", QList<QString>() << QUrl(readVarInText(cmd[3], var)).toString(), QList<QString>());
-                }
-            }
-        }
+    QVariantMap cache;
+    cache.insert("hits", matchCache.hits());
+    cache.insert("misses", matchCache.misses());
+    stats.insert("matchCache", cache);
 
-        else if (cmd[1] == "with_action_btn") {
-            if (cmd[2] == "search") {
-                if (cmd[3] != "") {
-                    QString search = "";
-                    for (int i = 3; i < cmd.length(); i++) {
-                        search.append(cmd.at(i));
-                        if (i != cmd.length()-1) search.append(" ");
-                    }
-                    readVarInText(search, var).replace(" ", "+");
+    return stats;
+}
 
-                    QString url = "https://www.duckduckgo.com/"+search.replace(" ", "%20");
+//===================================================
+//================ Private function =================
+//===================================================
 
-                    emit reponseSended("", true, "web_with_action_btn", QList<QString>() << url, QList<QString>());
-                }
-            }
+/**
+ * Execute an action of the engine
+ *
+ * @param cmd the words of the action
+ * @return false if the action is not an action of the engine or of the host actions of the plugins
+ */
+bool Engine::execAction(QList<QString> cmd)
+{
+    return actionTable.exec(cmd);
+}
 
-            else if (cmd[2] == "site") {
-                if (cmd[3] != "") {
-                    bool isUserEntry = true;
+/**
+ * Register the actions executed by the engine
+ */
+void Engine::registerActions()
+{
+    actionTable.add(ACTION_PATH("settings name"), [this](const ActionArgs &args) {
+        if (args.at(0) != "") settings.setValue(key_settings_name, readVarInText(args.at(0), conversation->var));
+    });
 
-                    for (int i = 0; i < cmd[2].length(); i++) {
-                        int nextIndex = 1 == cmd[2].length() ? i : i+1;
-                        int nextIndexB = 2 == cmd[2].length() ? i : i+2;
-                        int nextIndexC = 3 == cmd[2].length() ? i : i+3;
+    actionTable.add(ACTION_PATH("settings prop"), [this](const ActionArgs &args) {
+        if (args.at(0) != "") settings.setValue(key_settings_proposition, QVariant(readVarInText(args.at(0), conversation->var)).toBool());
+    });
 
-                        if (cmd[2].at(0) == 'h' && cmd[2].at(nextIndex) == 't' && cmd[2].at(nextIndexB) == 't' && cmd[2].at(nextIndexC) == 'p')
-                            isUserEntry = false;
-                    }
+    actionTable.add(ACTION_PATH("settings semantic"), [this](const ActionArgs &args) {
+        if (args.at(0) != "") {
+            settings.setValue(key_settings_semantic, QVariant(readVarInText(args.at(0), conversation->var)).toBool());
+            updateSettingsVar();
+            matchCache.clear();
+        }
+    });
+
+    actionTable.add(ACTION_PATH("settings show"), [this](const ActionArgs &) {
+        Tracer::hopSent("reply");
+        emit reponseSended(Reply(Reply::Settings, "", true, conversation->requestId));
+    });
+
+    actionTable.add(ACTION_PATH("app quit"), [this](const ActionArgs &) { emit quitRequested(); });
+    actionTable.add(ACTION_PATH("app hideWindow"), [this](const ActionArgs &) { emit hideWindow(); });
+    actionTable.add(ACTION_PATH("app showWindow"), [this](const ActionArgs &) { emit showWindow(); });
+    actionTable.add(ACTION_PATH("app home"), [this](const ActionArgs &) { emit showHomeScreen(); });
+    actionTable.add(ACTION_PATH("app previousPage"), [this](const ActionArgs &) { emit previousPage(); });
+    actionTable.add(ACTION_PATH("app stats"), [this](const ActionArgs &) { actionStats(); });
+
+    actionTable.add(ACTION_PATH("app notify"), [this](const ActionArgs &args) { actionNotify(args); },
+                    QList<QString>() << "-t" << "-c" << "-a");
+
+    actionTable.add(ACTION_PATH("app openLinkInDefaultBrowser"), [this](const ActionArgs &args) {
+        emit openUrl(QUrl(args.at(0)));
+    });
+
+    actionTable.add(ACTION_PATH("web_message without_action_btn search"), [this](const ActionArgs &args) {
+        actionWebSearch(args, Reply::WebWithoutActionBtn);
+    });
+
+    actionTable.add(ACTION_PATH("web_message without_action_btn site"), [this](const ActionArgs &args) {
+        actionWebSite(args, Reply::WebWithoutActionBtn);
+    });
+
+    actionTable.add(ACTION_PATH("web_message with_action_btn search"), [this](const ActionArgs &args) {
+        actionWebSearch(args, Reply::WebWithActionBtn);
+    });
+
+    actionTable.add(ACTION_PATH("web_message with_action_btn site"), [this](const ActionArgs &args) {
+        actionWebSite(args, Reply::WebWithActionBtn);
+    });
+}
 
-                    if (isUserEntry) emit reponseSended("", true, "web_with_action_btn", QList<QString>() << QUrl::fromUserInput(readVarInText(cmd[3], var)).toString(), QList<QString>());
-                    else emit reponseSended("", true, "web_with_action_btn", QList<QString>() << QUrl(readVarInText(cmd[3], var)).toString(), QList<QString>());
-                }
+/**
+ * Register the host actions of a plugin, these actions can be used by all the plugins
+ *
+ * @param plug the plugin
+ */
+void Engine::registerPluginActions(PluginInterfaceV2 *plug)
+{
+    foreach (QString path , plug->hostActions()) {
+        actionTable.add(ActionTable::hash(path), path, [this, plug](const ActionArgs &args) {
+            QList<QString> cmd = args.command;
+
+            for (int i = 0; i < cmd.length(); i++) {
+                cmd[i] = readVarInText(cmd.at(i), conversation->var);
             }
-        }
-    }
 
-    else {
-        return false;
+            setCaller(plug);
+            plug->execAction(cmd);
+        }, QList<QString>(), plug->pluginId());
     }
+}
 
-    return true;
+/**
+ * app stats, reply with the statistics of the engine
+ */
+void Engine::actionStats()
+{
+    QVariantMap stats = statistics();
+    QList<QString> lines;
+
+    auto latency = [](const QVariantMap &summary) {
+        return tr("%1, médiane %2 ms, p90 %3 ms, p99 %4 ms, max %5 ms")
+                .arg(summary.value("count").toULongLong())
+                .arg(summary.value("p50").toDouble(), 0, 'f', 2)
+                .arg(summary.value("p90").toDouble(), 0, 'f', 2)
+                .arg(summary.value("p99").toDouble(), 0, 'f', 2)
+                .arg(summary.value("max").toDouble(), 0, 'f', 2);
+    };
+
+    auto hitRate = [](const QVariantMap &cache) {
+        quint64 hits = cache.value("hits").toULongLong();
+        quint64 total = hits + cache.value("misses").toULongLong();
+
+        return tr("%1 % (%2/%3)").arg(total == 0 ? 0 : 100 * hits / total).arg(hits).arg(total);
+    };
+
+    QVariantMap rules = stats.value("rules").toMap();
+
+    lines.append(tr("Requêtes : %1").arg(latency(stats.value("utterances").toMap())));
+    lines.append(tr("Règles évaluées par requête : médiane %1, p90 %2, max %3")
+                 .arg(rules.value("p50").toLongLong()).arg(rules.value("p90").toLongLong()).arg(rules.value("max").toLongLong()));
+    lines.append(tr("Complétion par frappe : %1").arg(latency(stats.value("completions").toMap())));
+    lines.append(tr("Suggestions : %1").arg(latency(stats.value("suggestions").toMap())));
+    lines.append(tr("Cache des commandes : %1").arg(hitRate(stats.value("matchCache").toMap())));
+    lines.append(tr("Cache des règles : %1").arg(hitRate(stats.value("ruleCache").toMap())));
+
+    QVariantMap eventLoops = stats.value("eventLoops").toMap();
+    for (auto it = eventLoops.constBegin(); it != eventLoops.constEnd(); ++it)
+        lines.append(tr("Latence de la boucle %1 : %2").arg(it.key(), latency(it.value().toMap())));
+
+    QVariantMap actions = stats.value("actions").toMap();
+    for (auto it = actions.constBegin(); it != actions.constEnd(); ++it)
+        lines.append(tr("Actions de %1 : %2").arg(it.key(), latency(it.value().toMap())));
+
+    emitReply(Reply(Reply::Message, lines.join("\n"), true, conversation->requestId), "null");
+}
+
+/**
+ * app notify -t title -c text -a action
+ */
+void Engine::actionNotify(const ActionArgs &args)
+{
+    emit sendNotify(args.option("-t"), args.option("-c"), args.option("-a"));
+}
+
+/**
+ * web_message with_action_btn|without_action_btn search text
+ *
+ * @param args the words of the search
+ * @param type the type of web reply
+ */
+void Engine::actionWebSearch(const ActionArgs &args, Reply::Type type)
+{
+    if (args.at(0) == "") return;
+
+    QString search = readVarInText(args.text(), conversation->var);
+
+    Reply reply(type, "", true, conversation->requestId);
+    if (type == Reply::WebWithActionBtn) reply.setUrl("https://www.duckduckgo.com/"+search.replace(" ", "%20"));
+    else reply.setUrl("https://www.duckduckgo.com/"+search);
+    Tracer::hopSent("reply");
+    emit reponseSended(reply);
 }
 
 /**
- * Format user input to avoid spelling mistakes and send result to analize function
+ * web_message with_action_btn|without_action_btn site url
  *
- * @param _text the user input
+ * @param args the url, written by the user or by the plugin
+ * @param type the type of web reply
  */
-void Engine::format(QString text)
+void Engine::actionWebSite(const ActionArgs &args, Reply::Type type)
 {
+    if (args.at(0) == "") return;
+
+    QString site = readVarInText(args.at(0), conversation->var);
+
+    Reply reply(type, "", true, conversation->requestId);
+    if (site.startsWith("http")) reply.setUrl(QUrl(site).toString());
+    else reply.setUrl(QUrl::fromUserInput(site).toString());
+    Tracer::hopSent("reply");
+    emit reponseSended(reply);
+}
+
+/**
+ * Format user input to avoid spelling mistakes
+ *
+ * @param text the user input
+ * @return first dimension of the table => commands
+ *         second dimension of the table => words of commands
+ */
+QList<QList<QString>> Engine::format(QString text) const
+{
+    TRACE_SPAN("tokenize", "engine");
+    ALLOCATION_STAGE(Format);
+
     QList<QString> listWord;
     QString word = "";
 
@@ -277,7 +448,7 @@ void Engine::format(QString text)
         i++;
     }
 
-    analize(listCommands);
+    return listCommands;
 }
 
 /**
@@ -289,7 +460,7 @@ void Engine::format(QString text)
 void Engine::analize(QList<QList<QString>> array_cmd)
 {
     foreach (QList<QString> cmd , array_cmd) {
-        if (nextReplyItemId != "") {
+        if (conversation->nextReplyItemId != "") {
             bool reponseTrouved = analizePlugin(array_cmd, cmd);
 
             if (!reponseTrouved)
@@ -310,745 +481,591 @@ void Engine::analize(QList<QList<QString>> array_cmd)
  */
 void Engine::analizeAllPlugins(QList<QList<QString>> array_cmd, QList<QString> cmd)
 {
-    nextReplyNeedId.clear();
-    nextReplyPluginName.clear();
-    nextReplyItemId.clear();
-
-    if (!mainVolatil_prop.isEmpty()) {
-        main_prop = mainVolatil_prop;
-        mainVolatil_prop.clear();
-        while (removePropNuber != 0) {
-            prop.removeLast();
-            removePropNuber--;
+    conversation->nextReplyNeedId.clear();
+    conversation->nextReplyPluginName.clear();
+    conversation->nextReplyItemId.clear();
+
+    if (!conversation->mainVolatil_prop.isEmpty()) {
+        conversation->main_prop = conversation->mainVolatil_prop;
+        conversation->mainVolatil_prop.clear();
+        while (conversation->removePropNuber != 0) {
+            conversation->prop.removeLast();
+            conversation->removePropNuber--;
         }
         addBaseProp();
     }
 
-    bool isOk = false;
+    if (analizeNativeMatchers(cmd)) return;
+
+    RuleMatch match;
+    int speculated = conversation->speculativeCommands.indexOf(cmd);
+
+    // A command matched while the user was typing enters the cache only once it is sent
+    if (speculated != -1 && speculated < conversation->speculativeMatches.length()) {
+        match = conversation->speculativeMatches.at(speculated);
+        matchCache.insert(cmd, match);
+        perfStats.addRulesEvaluated(match.evaluated);
+    }
+    else if (!matchCache.find(cmd, &match)) {
+        match = matchAllPlugins(cmd);
+        matchCache.insert(cmd, match);
+        perfStats.addRulesEvaluated(match.evaluated);
+    }
+
     bool isRep = false;
 
-    foreach (PluginInterface *plug , listPlugins) {
-        if (plug->pluginId() != "fr.swifty.websearch") {
-            QString xml = plug->getDataXml();
-            QDomDocument m_doc;
-            m_doc.setContent(xml, false);
+    if (match.isValid())
+        isRep = execMatch(match, cmd, array_cmd[array_cmd.length()-1] == cmd);
 
-            QDomElement root = m_doc.documentElement();
-            QDomElement item = root.firstChildElement();
+    if (!isRep) {
+        QString search = cmd.join(" ");
 
-            while (!item.isNull() && !isOk) {
-                QDomElement props = item.firstChildElement();
-                var.clear();
-                QString cmdString;
-                for (int i = 0; i < cmd.length(); i++) {
-                    if (i == cmd.length()-1) cmdString.append(cmd.at(i));
-                    else cmdString.append(cmd.at(i)+" ");
-                }
-                var.append(cmdString);
+        if (recording != nullptr) {
+            recordMatch(isWebSearchInstalled() ? "fr.swifty.websearch" : "", -1, "", cmd);
+            return;
+        }
 
-                while (!props.isNull()) {
-                    if (props.tagName() == "Prop" && nextReplyItemId != "") {
-                        QDomElement mProp = props.firstChildElement();
-                        QList<QString> listSecondProp;
+        bool isPluginInstalled = false;
+        foreach (PluginInterfaceV2 *plug , listPlugins) {
+            if (plug->pluginId() == "fr.swifty.websearch") {
+                QMutexLocker locker(pluginLock());
+                isPluginInstalled = true;
+                setCaller(plug);
+                plug->execAction(QList<QString>() << "websearch" << search);
+            }
+        }
 
-                        while (!mProp.isNull()) {
-                            listSecondProp.append(mProp.text());
-                            mProp = mProp.nextSiblingElement();
-                        }
+        if (!isPluginInstalled) {
+            emitReply(Reply(Reply::Message, tr("Désolé, je ne comprends pas ! 😕"), false, conversation->requestId), "null");
 
-                        mainVolatil_prop = main_prop;
-                        main_prop = listSecondProp;
-                        prop.append(listSecondProp);
-                        removePropNuber = listSecondProp.length();
-                        addBaseProp();
-                    }
+            Reply reply(Reply::Message, tr("Pour obtenir plus de résultats, installez le plugin WebSearch"), true, conversation->requestId);
+            reply.addAction(tr("Chercher sur le web"), "web_message with_action_btn search "+search);
+            reply.addAction(tr("Télécharger le plugin"), "app openLinkInDefaultBrowser https://github.com/Swiftapp-hub/WebSearch-Plugin-Swifty-Assistant");
+            emitReply(reply, "null");
+        }
+    }
+}
 
-                    if (props.tagName() == "Keywords" && cmd.length() >= props.attribute("minWord").toInt() && cmd.length() <= props.attribute("maxWord").toInt()) {
-                        QDomElement words = props.firstChildElement();
-                        isOk = true;
+/**
+ * Search the item of the plugins which corresponds to the command, without executing it.
+ * The keywords of the rules are checked first, then the example phrases of the items.
+ *
+ * @param cmd the words list of the command actually in research
+ * @return the item found and its variables, invalid if no item corresponds
+ */
+RuleMatch Engine::matchAllPlugins(const QList<QString> &cmd) const
+{
+    TRACE_SPAN("match", "engine");
+    ALLOCATION_STAGE(Matching);
 
-                        while (!words.isNull() && isOk) {
-                            if (words.tagName() == "Words") {
-                                QDomElement word = words.firstChildElement();
-                                bool isContains = false;
+    RuleMatch match = matchRules(cmd);
 
-                                while (!word.isNull() && !isContains) {
-                                    isContains = cmd.contains(word.text());
-                                    word = word.nextSiblingElement();
-                                }
+    if (!match.isValid() && semanticEnabled)
+        match = matchSemantic(cmd);
 
-                                if (!isContains) isOk = false;
-                            }
+    return match;
+}
 
-                            if (words.tagName() == "NoWords") {
-                                QDomElement word = words.firstChildElement();
-                                bool isContains = false;
+/**
+ * Search the first item whose keywords correspond to the command
+ *
+ * @param cmd the words list of the command actually in research
+ * @return the item found and its variables, invalid if no item corresponds
+ */
+RuleMatch Engine::matchRules(const QList<QString> &cmd) const
+{
+    RequestArena::Scope arenaScope(&arena);
+    RuleMatch match;
+    QList<QString> words = spellCorrector.correct(cmd);
+
+    for (int p = 0; p < listPlugins.length(); p++) {
+        if (listPlugins.at(p)->pluginId() == "fr.swifty.websearch") continue;
+
+        const RuleSet &rules = listRules.at(p);
+        TokenIds tokenIds = rules.tokenIds(words, arena.resource());
+        // The words as typed check the <NoWords>, they are only converted if the corrector changed one
+        TokenIds typedIds(arena.resource());
+        if (words != cmd) typedIds = rules.tokenIds(cmd, arena.resource());
+        const TokenIds &noWordIds = words != cmd ? typedIds : tokenIds;
+
+        for (int i = 0; i < rules.items.length(); i++) {
+            match.evaluated++;
+
+            if (rules.items.at(i).matchKeywords(tokenIds, noWordIds)) {
+                match.plugin = p;
+                match.item = i;
+                match.vars = rules.items.at(i).extractVars(cmd, tokenIds, RuleItem::LastKeyword);
+                return match;
+            }
+        }
+    }
 
-                                while (!word.isNull() && !isContains) {
-                                    isContains = cmd.contains(word.text());
-                                    word = word.nextSiblingElement();
-                                }
+    return match;
+}
 
-                                if (isContains) isOk = false;
-                            }
+/**
+ * Search the item whose example phrases are the closest to the command
+ *
+ * @param cmd the words list of the command actually in research
+ * @return the item found and its variables, invalid if no example is close enough
+ */
+RuleMatch Engine::matchSemantic(const QList<QString> &cmd) const
+{
+    RequestArena::Scope arenaScope(&arena);
+    RuleMatch match;
+    int plugin = -1;
+    int item = -1;
 
-                            words = words.nextSiblingElement();
-                        }
+    if (semanticIndex.bestMatch(cmd, &plugin, &item)) {
+        const RuleSet &rules = listRules.at(plugin);
 
-                        if (isOk) idOfActualPlugin = plug->pluginId();
-                    }
+        match.plugin = plugin;
+        match.item = item;
+        match.vars = rules.items.at(item).extractVars(cmd, rules.tokenIds(spellCorrector.correct(cmd), arena.resource()), RuleItem::LastKeyword);
+    }
 
-                    if (props.tagName() == "Var" && isOk) {
-                        int index = -1;
-                        QList<QString> keywords;
-                        QString text;
-                        QDomElement word = props.firstChildElement();
+    return match;
+}
 
-                        while (!word.isNull()) {
-                            keywords.append(word.text());
-                            word = word.nextSiblingElement();
-                        }
+/**
+ * Index the example phrases of the items: the <Examples> of the items
+ * and the propositions of the plugins which are recognized by the rules
+ */
+void Engine::buildSemanticIndex()
+{
+    semanticIndex.clear();
 
-                        foreach (QString _word , keywords) {
-                            int i = cmd.lastIndexOf(_word);
-                            if (i >= index) index = i;
-                        }
+    for (int p = 0; p < listRules.length(); p++) {
+        const RuleSet &rules = listRules.at(p);
 
-                        if (index != -1) {
-                            for (int i = index+1; i < cmd.length(); i++) {
-                                text.isEmpty() ? text.append(cmd[i]) : text.append(" "+cmd[i]);
-                                if (i == index+props.attribute("max").toInt()) break;
-                            }
-                        }
+        if (listPlugins.at(p)->pluginId() == "fr.swifty.websearch") continue;
 
-                        if (text != "") var.append(text);
-                    }
+        for (int i = 0; i < rules.items.length(); i++) {
+            foreach (QString example , rules.items.at(i).examples) {
+                foreach (QList<QString> cmd , format(example)) {
+                    semanticIndex.add(cmd, p, i);
+                }
+            }
+        }
 
-                    if (props.tagName() == "Reply" && isOk) {
-                        QDomElement condi_or_rep = props.firstChildElement();
-                        bool result = false;
+        foreach (QString command , rules.commands) {
+            foreach (QList<QString> cmd , format(command)) {
+                RuleMatch match = matchRules(cmd);
+                if (match.isValid() && match.plugin == p) semanticIndex.add(cmd, p, match.item);
+            }
+        }
+    }
+}
 
-                        while (!condi_or_rep.isNull()) {
-                            if (condi_or_rep.tagName() == "rep") {
-                                QList<QString> repList;
+/**
+ * Send the reply and execute the actions of the item found for a command
+ *
+ * @param match the item found by matchAllPlugins
+ * @param cmd the words list of the command
+ * @param isFin if this is the last command of the user input
+ * @return if a reply has been sent
+ */
+bool Engine::execMatch(const RuleMatch &match, const QList<QString> &cmd, bool isFin)
+{
+    PluginInterfaceV2 *plug = listPlugins.at(match.plugin);
+    const RuleItem &item = listRules.at(match.plugin).items.at(match.item);
+    bool isRep = false;
 
-                                while (!condi_or_rep.isNull()) {
-                                    repList.append(condi_or_rep.text());
-                                    condi_or_rep = condi_or_rep.nextSiblingElement();
-                                }
+    conversation->idOfActualPlugin = plug->pluginId();
+    if (recording != nullptr) recordMatch(plug->pluginId(), match.item, item.id, cmd);
 
-                                if (!repList.isEmpty()) {
-                                    std::uniform_real_distribution<double> dist(0, repList.length());
-                                    int val = dist(*QRandomGenerator::global());
+    clearVars();
+    conversation->var.append(cmd.join(" "));
+    actionQueue.beginItem();
 
-                                    if (repList[val] != "null") sendReply(readVarInText(repList[val], var), array_cmd[array_cmd.length()-1] == cmd ? true : false, "message", plug->pluginId(), QList<QString>(), QList<QString>());
-                                    isRep = true;
-                                    if (item.attribute("id", "") != "" && item.attribute("needId", "") != "") {
-                                        nextReplyPluginName = plug->pluginId();
-                                        nextReplyNeedId = item.attribute("needId");
-                                        nextReplyItemId = item.attribute("id");
-                                    }
-                                }
-                            }
-                            else if (condi_or_rep.tagName() == "condition" && condi_or_rep.attribute("if") != "") {
-                                QString conditionA;
-                                QString conditionB;
-                                QString m_operator;
-                                bool isConditionA = true;
-
-                                for (int i = 0; i < condi_or_rep.attribute("if").length(); i++) {
-                                    if (condi_or_rep.attribute("if").at(i) == '!') { m_operator = '!'; isConditionA = false; }
-                                    else if (condi_or_rep.attribute("if").at(i) == '=') { m_operator = '='; isConditionA = false; }
-                                    else {
-                                        if (isConditionA) conditionA.append(condi_or_rep.attribute("if").at(i));
-                                        else conditionB.append(condi_or_rep.attribute("if").at(i));
-                                    }
-                                }
+    // As when the xml was read, a <Reply> only sees the <Var> written before it
+    for (const RuleStep &step : item.steps) {
+        if (step.kind == RuleStep::Var) {
+            setVar(item.vars.at(step.index), match.vars.value(step.index));
+        }
+        else if (step.kind == RuleStep::Reply) {
+            if (execReplyBlock(item.replies.at(step.index), isFin, plug->pluginId())) {
+                isRep = true;
+                if (item.id != "" && item.needId != "") {
+                    conversation->nextReplyPluginName = plug->pluginId();
+                    conversation->nextReplyNeedId = item.needId;
+                    conversation->nextReplyItemId = item.id;
+                }
+            }
+        }
+        else if (step.kind == RuleStep::Actions) {
+            execActionBlock(item.actions.at(step.index), plug, false);
+        }
+        else if (step.kind == RuleStep::Prop && conversation->nextReplyItemId != "") {
+            const QList<QString> &listSecondProp = item.props.at(step.index);
+
+            conversation->mainVolatil_prop = conversation->main_prop;
+            conversation->main_prop = listSecondProp;
+            conversation->prop.append(listSecondProp);
+            conversation->removePropNuber = listSecondProp.length();
+            addBaseProp();
+        }
+    }
 
-                                conditionA = readVarInText(conditionA, var);
-                                conditionB = readVarInText(conditionB, var);
+    clearVars();
 
-                                result = false;
+    return isRep;
+}
 
-                                if (m_operator == "!") {
-                                    if (conditionA != conditionB) result = true;
-                                    else result = false;
-                                }
-                                if (m_operator == "=") {
-                                    if (conditionA == conditionB) result = true;
-                                    else result = false;
-                                }
+/**
+ * Search a reponse in the plugin actually used
+ *
+ * @param array_cmd first dimension of the table => commands
+ *                  second dimension of the table => words of commands
+ * @param cmd the words list of the command actually in research
+ * @return if an reponse has been found
+ */
+bool Engine::analizePlugin(QList<QList<QString>> array_cmd, QList<QString> cmd)
+{
+    bool isOk = false;
+    bool isRep = false;
+    bool isFin = array_cmd[array_cmd.length()-1] == cmd;
 
-                                if (result) {
-                                    QDomElement m_rep = condi_or_rep.firstChildElement();
-                                    QList<QString> repList;
+    const QString itemId = conversation->nextReplyItemId;
+    const QString needId = conversation->nextReplyNeedId;
+    const QList<QString> words = spellCorrector.correct(cmd);
+    RequestArena::Scope arenaScope(&arena);
 
-                                    while (!m_rep.isNull()) {
-                                        repList.append(m_rep.text());
-                                        m_rep = m_rep.nextSiblingElement();
-                                    }
+    for (int p = 0; p < listPlugins.length() && !isOk; p++) {
+        PluginInterfaceV2 *plug = listPlugins.at(p);
+        const RuleSet &rules = listRules.at(p);
 
-                                    if (!repList.isEmpty()) {
-                                        std::uniform_real_distribution<double> dist(0, repList.length());
-                                        int val = dist(*QRandomGenerator::global());
-
-                                        if (repList[val] != "null") sendReply(readVarInText(repList[val], var), array_cmd[array_cmd.length()-1] == cmd ? true : false, "message", plug->pluginId(), QList<QString>(), QList<QString>());
-                                        isRep = true;
-                                        if (item.attribute("id", "") != "" && item.attribute("needId", "") != "") {
-                                            nextReplyPluginName = plug->pluginId();
-                                            nextReplyNeedId = item.attribute("needId");
-                                            nextReplyItemId = item.attribute("id");
-                                        }
-                                    }
-                                }
-                            }
-                            else if (condi_or_rep.tagName() == "else" && !result) {
-                                QDomElement m_rep = condi_or_rep.firstChildElement();
-                                QList<QString> repList;
+        if (plug->pluginId() != conversation->nextReplyPluginName) continue;
 
-                                while (!m_rep.isNull()) {
-                                    repList.append(m_rep.text());
-                                    m_rep = m_rep.nextSiblingElement();
-                                }
+        TokenIds tokenIds = rules.tokenIds(words, arena.resource());
+        TokenIds typedIds(arena.resource());
+        if (words != cmd) typedIds = rules.tokenIds(cmd, arena.resource());
+        const TokenIds &noWordIds = words != cmd ? typedIds : tokenIds;
 
-                                if (!repList.isEmpty()) {
-                                    std::uniform_real_distribution<double> dist(0, repList.length());
-                                    int val = dist(*QRandomGenerator::global());
+        for (int i = 0; i < rules.items.length() && !isOk; i++) {
+            if (rules.items.at(i).id != itemId) continue;
 
-                                    if (repList[val] != "null") sendReply(readVarInText(repList[val], var), array_cmd[array_cmd.length()-1] == cmd ? true : false, "message", plug->pluginId());
-                                    isRep = true;
-                                    if (item.attribute("id", "") != "" && item.attribute("needId", "") != "") {
-                                        nextReplyPluginName = plug->pluginId();
-                                        nextReplyNeedId = item.attribute("needId");
-                                        nextReplyItemId = item.attribute("id");
-                                    }
-                                }
-                            }
+            for (const RuleItem &secondItem : rules.items.at(i).children) {
+                if (secondItem.id != needId || !secondItem.matchKeywords(tokenIds, noWordIds)) continue;
 
-                            condi_or_rep = condi_or_rep.nextSiblingElement();
-                        }
-                    }
+                isOk = true;
+                conversation->idOfActualPlugin = plug->pluginId();
+                if (recording != nullptr) recordMatch(plug->pluginId(), i, secondItem.id, cmd);
 
-                    if (props.tagName() == "Actions" && isOk) {
-                        QDomElement action = props.firstChildElement();
-                        bool result = false;
+                const QList<QString> values = secondItem.extractVars(cmd, tokenIds, RuleItem::FirstKeyword);
 
-                        while (!action.isNull()) {
-                            if (action.tagName() == "action") {
-                                QList<QString> cmd = formatAction(action.text());
+                clearVars();
+                conversation->var.append(cmd.join(" "));
+                actionQueue.beginItem();
 
-                                if (!execAction(cmd)) {
-                                    for (int i = 0; i < cmd.length(); i++) {
-                                        cmd[i] = readVarInText(cmd.at(i), var);
+                for (const RuleStep &step : secondItem.steps) {
+                    if (step.kind == RuleStep::Var) {
+                        setVar(secondItem.vars.at(step.index), values.value(step.index));
+                    }
+                    else if (step.kind == RuleStep::Reply) {
+                        if (execReplyBlock(secondItem.replies.at(step.index), isFin, plug->pluginId())) {
+                            isRep = true;
+                            if (secondItem.needId != "")
+                                conversation->nextReplyNeedId = secondItem.needId;
+                            if (secondItem.needId == "null") {
+                                conversation->nextReplyNeedId.clear();
+                                conversation->nextReplyPluginName.clear();
+                                conversation->nextReplyItemId.clear();
+
+                                if (!conversation->mainVolatil_prop.isEmpty()) {
+                                    conversation->main_prop = conversation->mainVolatil_prop;
+                                    conversation->mainVolatil_prop.clear();
+                                    while (conversation->removePropNuber != 0) {
+                                        conversation->prop.removeLast();
+                                        conversation->removePropNuber--;
                                     }
-
-                                    plug->execAction(cmd);
+                                    addBaseProp();
                                 }
                             }
-                            else if (action.tagName() == "condition" && action.attribute("if") != "") {
-                                QString conditionA;
-                                QString conditionB;
-                                QString m_operator;
-                                bool isConditionA = true;
-
-                                for (int i = 0; i < action.attribute("if").length(); i++) {
-                                    if (action.attribute("if").at(i) == '!') { m_operator = '!'; isConditionA = false; }
-                                    else if (action.attribute("if").at(i) == '=') { m_operator = '='; isConditionA = false; }
-                                    else {
-                                        if (isConditionA) conditionA.append(action.attribute("if").at(i));
-                                        else conditionB.append(action.attribute("if").at(i));
-                                    }
-                                }
+                        }
+                    }
+                    else if (step.kind == RuleStep::Actions) {
+                        execActionBlock(secondItem.actions.at(step.index), plug, true);
+                    }
+                }
 
-                                conditionA = readVarInText(conditionA, var);
-                                conditionB = readVarInText(conditionB, var);
+                clearVars();
+                break;
+            }
+        }
+    }
 
-                                result = false;
+    if (!isRep) return false;
 
-                                if (m_operator == "!") {
-                                    if (conditionA != conditionB) result = true;
-                                    else result = false;
-                                }
-                                if (m_operator == "=") {
-                                    if (conditionA == conditionB) result = true;
-                                    else result = false;
-                                }
+    return true;
+}
 
-                                if (result) {
-                                    QDomElement m_action = action.firstChildElement();
+/**
+ * Send one of the replies of a <Reply> element
+ *
+ * @param block the compiled <Reply> element
+ * @param isFin if this is the last command of the user input
+ * @param id the plugin id
+ * @return if a <rep> list has been chosen
+ */
+bool Engine::execReplyBlock(const RuleBlock &block, bool isFin, const QString &id)
+{
+    bool result = false;
+    bool isRep = false;
 
-                                    while (!m_action.isNull()) {
-                                        QList<QString> cmd = formatAction(m_action.text());
+    for (const RuleBranch &branch : block) {
+        bool isChosen = false;
 
-                                        bool isDefaultAction = execAction(cmd);
+        if (branch.kind == RuleBranch::Always) {
+            isChosen = true;
+        }
+        else if (branch.kind == RuleBranch::If) {
+            result = isConditionTrue(branch.condition);
+            isChosen = result;
+        }
+        else if (branch.kind == RuleBranch::Else) {
+            isChosen = !result;
+        }
 
-                                        if (!isDefaultAction) {
-                                            for (int i = 0; i < cmd.length(); i++) {
-                                                cmd[i] = readVarInText(cmd.at(i), var);
-                                            }
+        if (isChosen && !branch.entries.isEmpty()) {
+            std::uniform_real_distribution<double> dist(0, branch.entries.length());
+            int val = dist(*QRandomGenerator::global());
 
-                                            plug->execAction(cmd);
-                                        }
+            if (branch.entries[val] != "null") emitReply(Reply(Reply::Message, readVarInText(branch.entries[val], conversation->var), isFin, conversation->requestId), id);
+            isRep = true;
+        }
+    }
 
-                                        m_action = m_action.nextSiblingElement();
-                                    }
-                                }
-                            }
-                            else if (action.tagName() == "else" && !result) {
-                                QDomElement m_action = action.firstChildElement();
+    return isRep;
+}
 
-                                while (!m_action.isNull()) {
-                                    QList<QString> cmd = formatAction(m_action.text());
+/**
+ * Execute the actions of an <Actions> element
+ *
+ * @param block the compiled <Actions> element
+ * @param plug the plugin which owns the actions
+ * @param isConversation if the item continues a conversation, then only the "settings" and "web_message" actions are executed by the engine
+ */
+void Engine::execActionBlock(const RuleBlock &block, PluginInterfaceV2 *plug, bool isConversation)
+{
+    // The actions have side effects, they are not executed by understand()
+    if (recording != nullptr) return;
 
-                                    bool isDefaultAction = execAction(cmd);
+    bool result = false;
 
-                                    if (!isDefaultAction) {
-                                        for (int i = 0; i < cmd.length(); i++) {
-                                            cmd[i] = readVarInText(cmd.at(i), var);
-                                        }
+    for (const RuleBranch &branch : block) {
+        bool isChosen = false;
 
-                                        plug->execAction(cmd);
-                                    }
+        if (branch.kind == RuleBranch::Always) {
+            isChosen = true;
+        }
+        else if (branch.kind == RuleBranch::If) {
+            result = isConditionTrue(branch.condition);
+            isChosen = result;
+        }
+        else if (branch.kind == RuleBranch::Else) {
+            isChosen = !result;
+        }
 
-                                    m_action = m_action.nextSiblingElement();
-                                }
-                            }
+        if (!isChosen) continue;
 
-                            action = action.nextSiblingElement();
-                        }
-                    }
+        foreach (QString action , branch.entries) {
+            QList<QString> cmd = formatAction(action);
+            if (cmd.isEmpty()) continue;
 
-                    props = props.nextSiblingElement();
-                }
+            bool isDefaultAction;
+            if (isConversation) isDefaultAction = cmd[0] == "settings" || cmd[0] == "web_message";
+            else isDefaultAction = actionTable.contains(cmd);
 
-                var.clear();
-                item = item.nextSiblingElement();
+            // The actions of the engine are executed now, the next elements of the item read the settings they change
+            if (isDefaultAction && actionTable.owner(cmd).isEmpty()) {
+                runEngineAction(cmd);
+                continue;
             }
-        }
-    }
 
-    if (!isRep) {
-        QString search = "";
-        for (int i = 0; i < cmd.length(); i++) {
-            search.append(cmd.at(i));
-            if (i != cmd.length()-1) search.append(" ");
-        }
+            PendingAction pendingAction;
+            pendingAction.cmd = cmd;
+            pendingAction.var = conversation->var;
+            pendingAction.namedVar = conversation->namedVar;
+            pendingAction.slotValues = conversation->slotValues;
 
-        bool isPluginInstalled = false;
-        foreach (PluginInterface *plug , listPlugins) {
-            if (plug->pluginId() == "fr.swifty.websearch") {
-                isPluginInstalled = true;
-                plug->execAction(QList<QString>() << "websearch" << search);
+            if (!isDefaultAction) {
+                for (int i = 0; i < cmd.length(); i++) {
+                    pendingAction.cmd[i] = readVarInText(cmd.at(i), conversation->var);
+                }
+
+                pendingAction.plugin = plug;
             }
-        }
 
-        if (!isPluginInstalled) {
-            sendReply(tr("Désolé, je ne comprends pas ! 😕"), false, "message", "null");
-            sendReply(tr("Pour obtenir plus de résultats, installez le plugin WebSearch"), true, "message", "null",
-                      QList<QString>() << "web_message with_action_btn search "+search << "app openLinkInDefaultBrowser https://github.com/Swiftapp-hub/WebSearch-Plugin-Swifty-Assistant",
-                      QList<QString>() << tr("Chercher sur le web") << tr("Télécharger le plugin"));
+            // The calls to the plugins are executed when the replies of the request are sent,
+            // a worker runs them before the response of the request, see SessionWorker
+            if (actionQueue.isEmpty() && !isWorker) QMetaObject::invokeMethod(this, &Engine::runActions, Qt::QueuedConnection);
+            actionQueue.append(pendingAction);
         }
     }
 }
 
 /**
- * Search a reponse in the plugin actually used
+ * Execute an action of the engine found in an item, it does not wait for the replies
  *
- * @param array_cmd first dimension of the table => commands
- *                  second dimension of the table => words of commands
- * @param cmd the words list of the command actually in research
- * @return if an reponse has been found
+ * @param cmd the words of the action
  */
-bool Engine::analizePlugin(QList<QList<QString>> array_cmd, QList<QString> cmd)
+void Engine::runEngineAction(const QList<QString> &cmd)
 {
-    bool isOk = false;
-    bool isRep = false;
-
-    foreach (PluginInterface *plug , listPlugins) {
-        if (plug->pluginId() == nextReplyPluginName) {
-            QString xml = plug->getDataXml();
-            QDomDocument m_doc;
-            m_doc.setContent(xml, false);
-
-            QDomElement root = m_doc.documentElement();
-            QDomElement item = root.firstChildElement();
+    TRACE_SPAN("execAction", "engine");
+    TRACE_ARG("action", cmd.join(" "));
+    QElapsedTimer timer;
+    timer.start();
 
-            while (!item.isNull() && !isOk) {
-                var.clear();
+    execAction(cmd);
 
-                if (item.attribute("id") == nextReplyItemId) {
-                    QDomElement secondItem = item.firstChildElement();
-
-                    while (!secondItem.isNull() && !isOk) {
-                        if (secondItem.tagName() == "Item" && secondItem.attribute("id") == nextReplyNeedId) {
-                            QDomElement props = secondItem.firstChildElement();
-                            QString cmdString;
-                            for (int i = 0; i < cmd.length(); i++) {
-                                if (i == cmd.length()-1) cmdString.append(cmd.at(i));
-                                else cmdString.append(cmd.at(i)+" ");
-                            }
-                            var.append(cmdString);
-
-                            while (!props.isNull()) {
-                                if (props.tagName() == "Keywords" && cmd.length() >= props.attribute("minWord").toInt() && cmd.length() <= props.attribute("maxWord").toInt()) {
-                                    QDomElement words = props.firstChildElement();
-                                    isOk = true;
+    qint64 nsecs = timer.nsecsElapsed();
+    actionQueue.record("engine "+cmd.value(0), nsecs);
+    perfStats.recordAction("engine", nsecs);
+    emit actionExecuted("engine", cmd.join(" "), nsecs);
+}
 
-                                    while (!words.isNull() && isOk) {
-                                        if (words.tagName() == "Words") {
-                                            QDomElement word = words.firstChildElement();
-                                            bool isContains = false;
+/**
+ * Execute the calls to the plugins found for the last request, the consecutive actions
+ * given to the same plugin are executed in one call
+ */
+void Engine::runActions()
+{
+    foreach (QList<PendingAction> batch , actionQueue.takeBatches()) {
+        const PendingAction &first = batch.first();
+        QString id = first.isEngineAction() ? "engine" : first.plugin->pluginId();
+        QElapsedTimer timer;
+
+        TRACE_SPAN("execAction", "plugin");
+        ALLOCATION_STAGE(PluginCall);
+        TRACE_ARG("plugin", id);
+        TRACE_ARG("action", first.cmd.join(" "));
+        LagMonitor::setPlugin(id);
+        QMutexLocker locker(pluginLock());
+
+        conversation->var = first.var;
+        conversation->namedVar = first.namedVar;
+        conversation->slotValues = first.slotValues;
+
+        timer.start();
+
+        if (first.isEngineAction()) {
+            execAction(first.cmd);
+        }
+        else if (batch.length() == 1) {
+            setCaller(first.plugin);
+            first.plugin->execSlotAction(first.cmd, first.slotValues);
+        }
+        else {
+            QList<QList<QString>> cmds;
+            foreach (PendingAction action , batch) cmds.append(action.cmd);
 
-                                            while (!word.isNull() && !isContains) {
-                                                isContains = cmd.contains(word.text());
-                                                word = word.nextSiblingElement();
-                                            }
+            setCaller(first.plugin);
+            first.plugin->execActions(cmds, first.slotValues);
+        }
 
-                                            if (!isContains) isOk = false;
-                                        }
+        qint64 nsecs = timer.nsecsElapsed();
+        perfStats.recordAction(id, nsecs);
 
-                                        if (words.tagName() == "NoWords") {
-                                            QDomElement word = words.firstChildElement();
-                                            bool isContains = false;
+        // The actions of a batch are executed by one call, their time goes to the batch counter instead of their verbs
+        if (batch.length() == 1) {
+            actionQueue.record(id+" "+first.cmd.value(0), nsecs);
+            emit actionExecuted(id, first.cmd.join(" "), nsecs);
+        }
+        else {
+            QList<QString> actions;
+            foreach (PendingAction action , batch) actions.append(action.cmd.join(" "));
 
-                                            while (!word.isNull() && !isContains) {
-                                                isContains = cmd.contains(word.text());
-                                                word = word.nextSiblingElement();
-                                            }
+            actionQueue.recordBatch(id, batch.length(), nsecs);
+            emit actionExecuted(id, actions.join("; "), nsecs);
+        }
 
-                                            if (isContains) isOk = false;
-                                        }
+        clearVars();
+    }
 
-                                        words = words.nextSiblingElement();
-                                    }
+    LagMonitor::setPlugin(QString());
+}
 
-                                    if (isOk) idOfActualPlugin = plug->pluginId();
-                                }
+/**
+ * Add the value of a <Var> or <Slot> element to the variables of the item found for a command:
+ * ?0 is the command, ?1, ?2... the filled elements in the order of the xml
+ * and ?{name} the words of a <Slot>, ?{name.value} its typed value
+ *
+ * @param ruleVar the element
+ * @param value the words returned for it by RuleItem::extractVars, empty if it is not filled
+ */
+void Engine::setVar(const RuleVar &ruleVar, const QString &value)
+{
+    if (value.isEmpty()) return;
 
-                                if (props.tagName() == "Var" && isOk) {
-                                    int index = -1;
-                                    QList<QString> keywords;
-                                    QString text;
-                                    QDomElement word = props.firstChildElement();
+    conversation->var.append(value);
 
-                                    while (!word.isNull()) {
-                                        keywords.append(word.text());
-                                        word = word.nextSiblingElement();
-                                    }
+    if (ruleVar.name.isEmpty()) return;
 
-                                    foreach (QString _word , keywords) {
-                                        index = cmd.lastIndexOf(_word);
-                                        if (index != -1) break;
-                                    }
+    QVariant typedValue = SlotParser::value(ruleVar.type, value, QDateTime::currentDateTime());
+    conversation->slotValues.insert(ruleVar.name, typedValue);
+    conversation->namedVar.insert(ruleVar.name, value);
+    conversation->namedVar.insert(ruleVar.name+".value", SlotParser::toText(typedValue));
+}
 
-                                    if (index != -1) {
-                                        for (int i = index+1; i < cmd.length(); i++) {
-                                            text.isEmpty() ? text.append(cmd[i]) : text.append(" "+cmd[i]);
-                                            if (i == index+props.attribute("max").toInt()) break;
-                                        }
-                                    }
+void Engine::clearVars()
+{
+    conversation->var.clear();
+    conversation->namedVar.clear();
+    conversation->slotValues.clear();
+}
 
-                                    if (text != "") var.append(text);
-                                }
+/**
+ * Evaluate the if attribute of a <condition>
+ *
+ * @param condition the compiled condition
+ * @return if the condition is true with the actual variables
+ */
+bool Engine::isConditionTrue(const RuleCondition &condition)
+{
+    QString conditionA = readVarInText(condition.left, conversation->var);
+    QString conditionB = readVarInText(condition.right, conversation->var);
 
-                                if (props.tagName() == "Reply" && isOk) {
-                                    QDomElement condi_or_rep = props.firstChildElement();
-                                    bool result = false;
-
-                                    while (!condi_or_rep.isNull()) {
-                                        if (condi_or_rep.tagName() == "rep") {
-                                            QList<QString> repList;
-
-                                            while (!condi_or_rep.isNull()) {
-                                                repList.append(condi_or_rep.text());
-                                                condi_or_rep = condi_or_rep.nextSiblingElement();
-                                            }
-
-                                            std::uniform_real_distribution<double> dist(0, repList.length());
-                                            int val = dist(*QRandomGenerator::global());
-
-                                            if (repList[val] != "null") sendReply(readVarInText(repList[val], var), array_cmd[array_cmd.length()-1] == cmd ? true : false, "message", plug->pluginId(), QList<QString>(), QList<QString>());
-                                            isRep = true;
-                                            if (secondItem.attribute("needId", "") != "")
-                                                nextReplyNeedId = secondItem.attribute("needId");
-                                            if (secondItem.attribute("needId", "") == "null") {
-                                                nextReplyNeedId.clear();
-                                                nextReplyPluginName.clear();
-                                                nextReplyItemId.clear();
-
-                                                if (!mainVolatil_prop.isEmpty()) {
-                                                    main_prop = mainVolatil_prop;
-                                                    mainVolatil_prop.clear();
-                                                    while (removePropNuber != 0) {
-                                                        prop.removeLast();
-                                                        removePropNuber--;
-                                                    }
-                                                    addBaseProp();
-                                                }
-                                            }
-                                        }
-                                        else if (condi_or_rep.tagName() == "condition" && condi_or_rep.attribute("if") != "") {
-                                            QString conditionA;
-                                            QString conditionB;
-                                            QString m_operator;
-                                            bool isConditionA = true;
-
-                                            for (int i = 0; i < condi_or_rep.attribute("if").length(); i++) {
-                                                if (condi_or_rep.attribute("if").at(i) == '!') { m_operator = "!"; isConditionA = false; }
-                                                else if (condi_or_rep.attribute("if").at(i) == '=') { m_operator = "="; isConditionA = false; }
-                                                else {
-                                                    if (isConditionA) conditionA.append(condi_or_rep.attribute("if").at(i));
-                                                    else conditionB.append(condi_or_rep.attribute("if").at(i));
-                                                }
-                                            }
-
-                                            conditionA = readVarInText(conditionA, var);
-                                            conditionB = readVarInText(conditionB, var);
-
-                                            result = false;
-
-                                            if (m_operator == "!") {
-                                                if (conditionA != conditionB) result = true;
-                                                else result = false;
-                                            }
-                                            if (m_operator == "=") {
-                                                if (conditionA == conditionB) result = true;
-                                                else result = false;
-                                            }
-
-                                            if (result) {
-                                                QDomElement m_rep = condi_or_rep.firstChildElement();
-                                                QList<QString> repList;
-
-                                                while (!m_rep.isNull()) {
-                                                    repList.append(m_rep.text());
-                                                    m_rep = m_rep.nextSiblingElement();
-                                                }
-
-                                                std::uniform_real_distribution<double> dist(0, repList.length());
-                                                int val = dist(*QRandomGenerator::global());
-
-                                                if (repList[val] != "null") sendReply(readVarInText(repList[val], var), array_cmd[array_cmd.length()-1] == cmd ? true : false, "message", plug->pluginId(), QList<QString>(), QList<QString>());
-                                                isRep = true;
-                                                if (secondItem.attribute("needId", "") != "")
-                                                    nextReplyNeedId = secondItem.attribute("needId");
-                                                if (secondItem.attribute("needId", "") == "null") {
-                                                    nextReplyNeedId.clear();
-                                                    nextReplyPluginName.clear();
-                                                    nextReplyItemId.clear();
-
-                                                    if (!mainVolatil_prop.isEmpty()) {
-                                                        main_prop = mainVolatil_prop;
-                                                        mainVolatil_prop.clear();
-                                                        while (removePropNuber != 0) {
-                                                            prop.removeLast();
-                                                            removePropNuber--;
-                                                        }
-                                                        addBaseProp();
-                                                    }
-                                                }
-                                            }
-                                        }
-                                        else if (condi_or_rep.tagName() == "else" && !result) {
-                                            QDomElement m_rep = condi_or_rep.firstChildElement();
-                                            QList<QString> repList;
-
-                                            while (!m_rep.isNull()) {
-                                                repList.append(m_rep.text());
-                                                m_rep = m_rep.nextSiblingElement();
-                                            }
-
-                                            std::uniform_real_distribution<double> dist(0, repList.length());
-                                            int val = dist(*QRandomGenerator::global());
-
-                                            if (repList[val] != "null") sendReply(readVarInText(repList[val], var), array_cmd[array_cmd.length()-1] == cmd ? true : false, "message", plug->pluginId(), QList<QString>(), QList<QString>());
-                                            isRep = true;
-                                            if (secondItem.attribute("needId", "") != "")
-                                                nextReplyNeedId = secondItem.attribute("needId");
-                                            if (secondItem.attribute("needId", "") == "null") {
-                                                nextReplyNeedId.clear();
-                                                nextReplyPluginName.clear();
-                                                nextReplyItemId.clear();
-
-                                                if (!mainVolatil_prop.isEmpty()) {
-                                                    main_prop = mainVolatil_prop;
-                                                    mainVolatil_prop.clear();
-                                                    while (removePropNuber != 0) {
-                                                        prop.removeLast();
-                                                        removePropNuber--;
-                                                    }
-                                                    addBaseProp();
-                                                }
-                                            }
-                                        }
-
-                                        condi_or_rep = condi_or_rep.nextSiblingElement();
-                                    }
-                                }
+    if (condition.op == RuleCondition::NotEqual) return conditionA != conditionB;
+    if (condition.op == RuleCondition::Equal) return conditionA == conditionB;
 
-                                if (props.tagName() == "Actions" && isOk) {
-                                    QDomElement action = props.firstChildElement();
-                                    bool result = false;
-
-                                    while (!action.isNull()) {
-                                        if (action.tagName() == "action") {
-                                            QList<QString> cmd;
-                                            QString word = "";
-
-                                            for (int i = 0; i < action.text().length(); i++) {
-                                                if (action.text().at(i) == ' ') {
-                                                    if (!word.isEmpty()) {
-                                                        cmd.append(word);
-                                                        word.clear();
-                                                    }
-                                                }
-                                                else {
-                                                    word.append(action.text().at(i));
-                                                }
-
-                                                if (i == action.text().length()-1) {
-                                                    cmd.append(word);
-                                                    word.clear();
-                                                }
-                                            }
-
-                                            if (cmd[0] == "settings" || cmd[0] == "web_message") {
-                                                execAction(cmd);
-                                            }
-                                            else {
-                                                for (int i = 0; i < cmd.length(); i++) {
-                                                    cmd[i] = readVarInText(cmd.at(i), var);
-                                                }
-
-                                                plug->execAction(cmd);
-                                            }
-                                        }
-                                        else if (action.tagName() == "condition" && action.attribute("if") != "") {
-                                            QString conditionA;
-                                            QString conditionB;
-                                            QString m_operator;
-                                            bool isConditionA = true;
-
-                                            for (int i = 0; i < action.attribute("if").length(); i++) {
-                                                if (action.attribute("if").at(i) == '!') { m_operator = '!'; isConditionA = false; }
-                                                else if (action.attribute("if").at(i) == '=') { m_operator = '='; isConditionA = false; }
-                                                else {
-                                                    if (isConditionA) conditionA.append(action.attribute("if").at(i));
-                                                    else conditionB.append(action.attribute("if").at(i));
-                                                }
-                                            }
-
-                                            conditionA = readVarInText(conditionA, var);
-                                            conditionB = readVarInText(conditionB, var);
-
-                                            result = false;
-
-                                            if (m_operator == "!") {
-                                                if (conditionA != conditionB) result = true;
-                                                else result = false;
-                                            }
-                                            if (m_operator == "=") {
-                                                if (conditionA == conditionB) result = true;
-                                                else result = false;
-                                            }
-
-                                            if (result) {
-                                                QDomElement m_action = action.firstChildElement();
-
-                                                while (!m_action.isNull()) {
-                                                    QList<QString> cmd;
-                                                    QString word = "";
-
-                                                    for (int i = 0; i < m_action.text().length(); i++) {
-                                                        if (m_action.text().at(i) == ' ') {
-                                                            if (!word.isEmpty()) {
-                                                                cmd.append(word);
-                                                                word.clear();
-                                                            }
-                                                        }
-                                                        else {
-                                                            word.append(m_action.text().at(i));
-                                                        }
-
-                                                        if (i == m_action.text().length()-1) {
-                                                            cmd.append(word);
-                                                            word.clear();
-                                                        }
-                                                    }
-
-                                                    if (cmd[0] == "settings" || cmd[0] == "web_message") {
-                                                        execAction(cmd);
-                                                    }
-                                                    else {
-                                                        for (int i = 0; i < cmd.length(); i++) {
-                                                            cmd[i] = readVarInText(cmd.at(i), var);
-                                                        }
-
-                                                        plug->execAction(cmd);
-                                                    }
-
-                                                    m_action = m_action.nextSiblingElement();
-                                                }
-                                            }
-                                        }
-                                        else if (action.tagName() == "else" && !result) {
-                                            QDomElement m_action = action.firstChildElement();
-
-                                            while (!m_action.isNull()) {
-                                                QList<QString> cmd;
-                                                QString word = "";
-
-                                                for (int i = 0; i < m_action.text().length(); i++) {
-                                                    if (m_action.text().at(i) == ' ') {
-                                                        if (!word.isEmpty()) {
-                                                            cmd.append(word);
-                                                            word.clear();
-                                                        }
-                                                    }
-                                                    else {
-                                                        word.append(m_action.text().at(i));
-                                                    }
-
-                                                    if (i == m_action.text().length()-1) {
-                                                        cmd.append(word);
-                                                        word.clear();
-                                                    }
-                                                }
-
-                                                if (cmd[0] == "settings" || cmd[0] == "web_message") {
-                                                    execAction(cmd);
-                                                }
-                                                else {
-                                                    for (int i = 0; i < cmd.length(); i++) {
-                                                        cmd[i] = readVarInText(cmd.at(i), var);
-                                                    }
-
-                                                    plug->execAction(cmd);
-                                                }
-
-                                                m_action = m_action.nextSiblingElement();
-                                            }
-                                        }
-
-                                        action = action.nextSiblingElement();
-                                    }
-                                }
+    return false;
+}
 
-                                props = props.nextSiblingElement();
-                            }
-                        }
+/**
+ * Give the command to the plugins which have their own matcher
+ *
+ * @param cmd the words list of the command actually in research
+ * @return if a plugin has taken the command
+ */
+bool Engine::analizeNativeMatchers(const QList<QString> &cmd)
+{
+    PluginInterfaceV2 *bestPlugin = nullptr;
+    int bestScore = PluginInterfaceV2::NoMatch;
+    QMutexLocker locker(pluginLock());
 
-                        secondItem = secondItem.nextSiblingElement();
-                    }
-                }
+    foreach (PluginInterfaceV2 *plug , listPlugins) {
+        if (plug->pluginId() != "fr.swifty.websearch") {
+            int score = plug->match(cmd);
 
-                var.clear();
-                item = item.nextSiblingElement();
+            if (score > bestScore) {
+                bestScore = score;
+                bestPlugin = plug;
             }
         }
     }
 
-    if (!isRep) return false;
+    if (bestPlugin == nullptr) return false;
+
+    conversation->idOfActualPlugin = bestPlugin->pluginId();
+
+    if (recording != nullptr) {
+        recordMatch(bestPlugin->pluginId(), -1, "", cmd);
+    }
+    else {
+        setCaller(bestPlugin);
+        bestPlugin->execMatch(cmd);
+    }
 
     return true;
 }
@@ -1061,6 +1078,8 @@ void Engine::updateSettingsVar()
     soundEnabled = var.toBool();
     var = settings.value(key_settings_proposition, true);
     propEnabled = var.toBool();
+    var = settings.value(key_settings_semantic, false);
+    semanticEnabled = var.toBool();
 }
 
 /**
@@ -1072,6 +1091,9 @@ void Engine::updateSettingsVar()
  */
 QString Engine::readVarInText(QString text, QList<QString> var)
 {
+    TRACE_SPAN("template", "engine");
+    ALLOCATION_STAGE(Template);
+
     QString reply;
 
     for (int i = 0; i < text.length(); i++) {
@@ -1086,6 +1108,11 @@ QString Engine::readVarInText(QString text, QList<QString> var)
             if (volatil.toInt() < var.length()) reply.append(var[volatil.toInt()]);
             i++;
         }
+        else if (ch == "?" && text.at(nextIndex) == '{' && text.indexOf('}', nextIndex) != -1) {
+            int end = text.indexOf('}', nextIndex);
+            reply.append(conversation->namedVar.value(text.mid(nextIndex+1, end-nextIndex-1)));
+            i = end;
+        }
         else if (ch == "?" && text.at(nextIndex) == 'n' && text.at(nextIndexB) == 'a' && text.at(nextIndexC) == 'm' && text.at(nextIndexD) == 'e') {
             updateSettingsVar();
             reply.append(userName);
@@ -1149,6 +1176,89 @@ QList<QString> Engine::formatAction(QString action)
     return cmd;
 }
 
+/**
+ * Send a reply to the interface and remember the plugin which sent it
+ *
+ * @param reply the reply
+ * @param id the plugin id
+ */
+void Engine::emitReply(const Reply &reply, const QString &id)
+{
+    ALLOCATION_STAGE(Signal);
+
+    if (recording != nullptr && !recording->isEmpty()) recording->last().replies.append(reply.text());
+
+    Tracer::hopSent("reply");
+
+    emit reponseSended(reply);
+    conversation->idOfActualPlugin = id;
+}
+
+/**
+ * Remember the item found for a command while understand() is running
+ *
+ * @param pluginId the plugin id, empty if no plugin understands the command
+ * @param item the index of the item in the xml of the plugin, -1 for a native matcher or the web search
+ * @param itemId the id attribute of the item
+ * @param cmd the words list of the command
+ */
+void Engine::recordMatch(const QString &pluginId, int item, const QString &itemId, const QList<QString> &cmd)
+{
+    CommandResult result;
+    result.command = cmd.join(" ");
+    result.pluginId = pluginId;
+    result.item = item;
+    result.itemId = itemId;
+
+    recording->append(result);
+}
+
+/**
+ * The engine which has loaded the plugins of the daemon mode receives their signals too,
+ * it ignores them: they belong to the engine which called the plugin, see PluginRelay.
+ *
+ * @return if the engine serves no session
+ */
+bool Engine::isIdleWorker() const
+{
+    return isWorker && conversation == &ownConversation;
+}
+
+/**
+ * Remember that the conversation of the engine calls a plugin, the signals the plugin
+ * sends later go to its session, see PluginRelay. Called with the lock of the plugins.
+ *
+ * @param plug the plugin
+ */
+void Engine::setCaller(const PluginInterfaceV2 *plug) const
+{
+    if (isWorker) PluginRelay::setCaller(plug, this, conversation->session);
+}
+
+/**
+ * The plugins are not written to be called by several threads at once
+ *
+ * @return the lock of the calls to the plugins in worker mode, nullptr otherwise
+ */
+QRecursiveMutex *Engine::pluginLock() const
+{
+    static QRecursiveMutex mutex;
+
+    return isWorker ? &mutex : nullptr;
+}
+
+/**
+ * @return if the WebSearch plugin is installed
+ */
+bool Engine::isWebSearchInstalled() const
+{
+    foreach (PluginInterfaceV2 *plug , listPlugins) {
+        if (plug->pluginId() == "fr.swifty.websearch") return true;
+    }
+
+    return false;
+}
+
 //===================================================
 //===================== Slots =======================
 //===================================================
@@ -1160,7 +1270,26 @@ QList<QString> Engine::formatAction(QString action)
  */
 void Engine::messageReceived(QString message)
 {
-    format(message);
+    TRACE_SPAN("message", "engine");
+    ALLOCATION_REQUEST("message");
+    if (!isWorker) Tracer::hopReceived("message");
+
+    conversation->requestId++;
+    speculationTimer.stop();
+
+    RequestArena::Scope arenaScope(&arena);
+    QElapsedTimer timer;
+    timer.start();
+
+    // The matching of this text has already been done while the user was typing
+    if (message == conversation->speculativeText) analize(conversation->speculativeCommands);
+    else analize(format(message));
+
+    conversation->speculativeText.clear();
+    conversation->speculativeCommands.clear();
+    conversation->speculativeMatches.clear();
+
+    perfStats.recordUtterance(timer.nsecsElapsed());
 }
 
 /**
@@ -1170,36 +1299,66 @@ void Engine::messageReceived(QString message)
  */
 void Engine::textChanged(QString text)
 {
-    for (int i = showedProp.length()-1; i >= 0; i--) {
-        QString compareText = showedProp.at(i);
+    TRACE_SPAN("completion", "engine");
+    ALLOCATION_REQUEST("keystroke");
+    if (!isWorker) Tracer::hopReceived("newText");
+
+    QElapsedTimer timer;
+    timer.start();
+
+    conversation->speculativeInput = text;
+    if (!isWorker) speculationTimer.start();
+
+    for (int i = conversation->showedProp.length()-1; i >= 0; i--) {
+        QString compareText = conversation->showedProp.at(i);
         compareText.truncate(text.length());
 
         if (text.compare(compareText, Qt::CaseInsensitive) != 0) {
             emit removeProp(i);
-            showedProp.removeAt(i);
+            conversation->showedProp.removeAt(i);
         }
     }
 
-    foreach (QString myText, prop) {
-        if (isGoogleSuggest) emit removeAllProp();
-        isGoogleSuggest = false;
+    foreach (QString myText, conversation->prop) {
+        if (conversation->isGoogleSuggest) emit removeAllProp();
+        conversation->isGoogleSuggest = false;
 
         QString compareText = myText;
         compareText.truncate(text.length());
 
-        if (text.compare(compareText, Qt::CaseInsensitive) == 0 && showedProp.indexOf(myText) == -1) {
+        if (text.compare(compareText, Qt::CaseInsensitive) == 0 && conversation->showedProp.indexOf(myText) == -1) {
             emit addProp(myText);
-            showedProp.append(myText);
+            conversation->showedProp.append(myText);
         }
     }
 
-    if (showedProp.length() == 0 || isGoogleSuggest) {
-        isGoogleSuggest = true;
+    if ((conversation->showedProp.length() == 0 || conversation->isGoogleSuggest) && !isWorker) {
+        conversation->isGoogleSuggest = true;
         emit removeAllProp();
 
         QString url = "http://google.com/complete/search?output=toolbar&q="+text;
-        googleSuggestNetworkManager.get(QNetworkRequest(url));
+        QNetworkReply *networkReply = googleSuggestNetworkManager.get(QNetworkRequest(url));
+        networkReply->setProperty("requestTime", perfStats.now());
     }
+
+    perfStats.recordCompletion(timer.nsecsElapsed());
+}
+
+/**
+ * Called when the user stops typing, match the text in advance so that
+ * the reply is sent immediately if the user sends it unchanged
+ */
+void Engine::speculate()
+{
+    TRACE_SPAN("speculate", "engine");
+    RequestArena::Scope arenaScope(&arena);
+
+    conversation->speculativeCommands = format(conversation->speculativeInput);
+    conversation->speculativeText = conversation->speculativeInput;
+    conversation->speculativeMatches.clear();
+
+    // Kept in the conversation, not in matchCache, so the prefixes typed do not evict the commands sent
+    foreach (QList<QString> cmd , conversation->speculativeCommands) conversation->speculativeMatches.append(matchAllPlugins(cmd));
 }
 
 /**
@@ -1208,43 +1367,29 @@ void Engine::textChanged(QString text)
 void Engine::addBaseProp()
 {
     emit removeAllProp();
-    showedProp.clear();
+    conversation->showedProp.clear();
 
-    foreach (QString text , main_prop) {
+    foreach (QString text , conversation->main_prop) {
         emit addProp(text);
-        showedProp.append(text);
+        conversation->showedProp.append(text);
     }
 }
 
 /**
- * This function show the qml code of a plugin
+ * This function show the qml code of a plugin, the interface compiles it once by source, see QmlComponentCache
  *
  * @param qml the qml code
  * @param id the plugin id
  */
 void Engine::showQml(QString qml, QString id)
 {
-    QDir dir(QDir::homePath());
-    if (!dir.exists(".swifty_cache")) dir.mkdir(".swifty_cache");
-    dir.cd(".swifty_cache");
-
-    QString path = dir.path()+"/"+id.replace(".", "_")+".qml";
-    QString qmlUrl = "file:///"+dir.path()+"/"+id.replace(".", "_")+".qml";
-
-    QFile file(path);
-    if (file.exists()) file.remove();
-    if(!file.open(QIODevice::ReadWrite | QIODevice::Text)) {
-        qDebug("Error write qml file");
-        return;
-    }
-
-    QTextStream flux(&file);
-    flux.setCodec("UTF-8");
+    if (isIdleWorker()) return;
 
-    flux << qml;
+    TRACE_SPAN("showQml", "engine");
+    TRACE_ARG("plugin", id);
 
-    emit showQmlFile(qmlUrl);
-    idOfActualPlugin = id.replace("_", ".");
+    emit showQmlSource(qml, id);
+    conversation->idOfActualPlugin = id;
 }
 
 /**
@@ -1252,11 +1397,19 @@ void Engine::showQml(QString qml, QString id)
  */
 void Engine::getAllPlugin()
 {
-    foreach (PluginInterface *plugin, listPlugins) {
+    foreach (PluginInterfaceV2 *plugin, listPlugins) {
         emit pluginTrouved(plugin->pluginId());
     }
 }
 
+/**
+ * Emit a signal with the statistics of the engine, displayed by the settings
+ */
+void Engine::getStatistics()
+{
+    emit statisticsSended(statistics());
+}
+
 /**
  * When the engine has found an reponse this function is called
  *
@@ -1268,13 +1421,41 @@ void Engine::getAllPlugin()
  */
 void Engine::sendReply(QString reply, bool isFin, QString typeMessage, QString id, QList<QString> url, QList<QString> text)
 {
-    emit reponseSended(reply, isFin, typeMessage, url, text);
-    idOfActualPlugin = id;
+    if (isIdleWorker()) return;
+
+    Reply::Type type = Reply::typeFromString(typeMessage);
+    Reply message(type, reply, isFin, conversation->requestId);
+
+    if (type == Reply::WebWithoutActionBtn || type == Reply::WebWithActionBtn) {
+        message.setUrl(url.value(0));
+    }
+    else {
+        for (int i = 0; i < url.length(); i++) {
+            message.addAction(text.value(i), url.at(i));
+        }
+    }
+
+    emitReply(message, id);
 }
 
+/**
+ * Send a message of the qml interface of a plugin to the plugins
+ *
+ * @param message the message
+ */
 void Engine::sendMessageToPlugin(QString message)
 {
-    emit signalSendMessageToPlugin(message, idOfActualPlugin);
+    // A queued signal would run the slot in the thread of the plugins, outside of the lock of the workers
+    if (isWorker) {
+        QMutexLocker locker(pluginLock());
+        foreach (PluginInterfaceV2 *plug , listPlugins) {
+            setCaller(plug);
+            plug->messageReceived(message, conversation->idOfActualPlugin);
+        }
+        return;
+    }
+
+    emit signalSendMessageToPlugin(message, conversation->idOfActualPlugin);
 }
 
 /**
@@ -1284,7 +1465,9 @@ void Engine::sendMessageToPlugin(QString message)
  */
 void Engine::receiveMessageSendedToQml(QString message)
 {
-    emit pluginToQml(message, idOfActualPlugin);
+    if (isIdleWorker()) return;
+
+    emit pluginToQml(message, conversation->idOfActualPlugin);
 }
 
 void Engine::removePlugin(QString id)
@@ -1299,11 +1482,15 @@ void Engine::removePlugin(QString id)
         QObject *plugin = pluginLoader.instance();
 
         if (plugin) {
+            PluginInterfaceV2 *pluginsInterfaceV2 = qobject_cast<PluginInterfaceV2 *>(plugin);
             PluginInterface *pluginsInterface = qobject_cast<PluginInterface *>(plugin);
-            if (pluginsInterface) {
-                if (pluginsInterface->pluginId() == id) {
-                    QFile::remove(pluginsDir.absoluteFilePath(fileName));
-                }
+            QString pluginId;
+
+            if (pluginsInterfaceV2) pluginId = pluginsInterfaceV2->pluginId();
+            else if (pluginsInterface) pluginId = pluginsInterface->pluginId();
+
+            if (!pluginId.isEmpty() && pluginId == id) {
+                QFile::remove(pluginsDir.absoluteFilePath(fileName));
             }
         }
     }
@@ -1316,11 +1503,20 @@ void Engine::removePlugin(QString id)
  */
 void Engine::scanPlugin()
 {
-    prop.clear();
-    main_prop.clear();
-    showedProp.clear();
-    mainVolatil_prop.clear();
+    TRACE_SPAN("scan plugins", "engine");
+
+    pluginProp.clear();
+    pluginMainProp.clear();
+    actionQueue.clear();
+    foreach (PluginInterfaceV2 *plug , listPlugins) actionTable.removeOwner(plug->pluginId());
     listPlugins.clear();
+    listRules.clear();
+    matchCache.clear();
+    conversation->speculativeText.clear();
+    conversation->speculativeCommands.clear();
+    conversation->speculativeMatches.clear();
+    qDeleteAll(listV1Adapters);
+    listV1Adapters.clear();
 
     QDir pluginsDir(QDir::homePath());
     if (!pluginsDir.exists("SwiftyPlugins")) pluginsDir.mkdir("SwiftyPlugins");
@@ -1328,48 +1524,177 @@ void Engine::scanPlugin()
 
     const QStringList entries = pluginsDir.entryList(QDir::Files);
 
+    RuleCache ruleCache;
+    ruleCache.load();
+    bool isCacheOutdated = false;
+
     foreach (QString fileName , entries) {
         QString ext = fileName.right(fileName.length()-1-fileName.lastIndexOf("."));
 
         if (ext == "sw") {
+            TRACE_SPAN("load plugin", "plugin");
+            TRACE_ARG("file", fileName);
+            LagMonitor::setPlugin(fileName);
+
             QPluginLoader pluginLoader(pluginsDir.absoluteFilePath(fileName));
             QObject *plugin = pluginLoader.instance();
 
             if (plugin) {
-                PluginInterface *pluginsInterface = qobject_cast<PluginInterface *>(plugin);
+                PluginInterfaceV2 *pluginsInterface = qobject_cast<PluginInterfaceV2 *>(plugin);
+
+                // Plugins of the first version are used through an adapter
+                if (!pluginsInterface) {
+                    PluginInterface *pluginsInterfaceV1 = qobject_cast<PluginInterface *>(plugin);
+
+                    if (pluginsInterfaceV1) {
+                        PluginV1Adapter *adapter = new PluginV1Adapter(pluginsInterfaceV1);
+                        listV1Adapters.append(adapter);
+                        pluginsInterface = adapter;
+                    }
+                }
+
                 if (pluginsInterface) {
-                    connect(pluginsInterface->getObject(), SIGNAL(sendMessage(QString,bool,QString,QString,QList<QString>,QList<QString>)), this, SLOT(sendReply(QString,bool,QString,QString,QList<QString>,QList<QString>)));
-                    connect(pluginsInterface->getObject(), SIGNAL(showQml(QString,QString)), this, SLOT(showQml(QString,QString)));
-                    connect(pluginsInterface->getObject(), SIGNAL(sendMessageToQml(QString)), this, SLOT(receiveMessageSendedToQml(QString)));
-                    connect(pluginsInterface->getObject(), SIGNAL(execAction(QString)), this, SLOT(executeAction(QString)));
-                    connect(this, SIGNAL(signalSendMessageToPlugin(QString,QString)), pluginsInterface->getObject(), SLOT(messageReceived(QString,QString)));
+                    connectPlugin(pluginsInterface);
 
-                    QList<QString> plug_prop = pluginsInterface->getCommande();
+                    // The rules are compiled again only if the xml or the library of the plugin changed
+                    QString xml = pluginsInterface->getDataXml();
+                    QByteArray key = RuleCache::key(xml, QFileInfo(pluginsDir.absoluteFilePath(fileName)));
+                    RuleSet rules;
+
+                    bool isCached = ruleCache.find(key, &rules);
+                    perfStats.recordRuleCache(isCached);
+
+                    if (!isCached) {
+                        TRACE_SPAN("xml parse", "engine");
+                        rules = RuleSet::compile(pluginsInterface->pluginId(), xml, pluginsInterface->getCommande(), key);
+                        isCacheOutdated = true;
+                    }
+
+                    QList<QString> plug_prop = rules.commands;
                     if (!plug_prop.empty()) {
                         std::uniform_real_distribution<double> dist(0, plug_prop.length());
                         int val = dist(*QRandomGenerator::global());
 
-                        main_prop.append(plug_prop.at(val));
-                        prop.append(plug_prop);
+                        pluginMainProp.append(plug_prop.at(val));
+                        pluginProp.append(plug_prop);
                     }
 
                     listPlugins.append(pluginsInterface);
+                    listRules.append(rules);
+                    registerPluginActions(pluginsInterface);
                 }
             }
         }
     }
+
+    LagMonitor::setPlugin(QString());
+
+    conversation->prop = pluginProp;
+    conversation->main_prop = pluginMainProp;
+    conversation->showedProp.clear();
+    conversation->mainVolatil_prop.clear();
+
+    if (isCacheOutdated || ruleCache.count() != listRules.length()) ruleCache.save(listRules);
+
+    spellCorrector.build(listRules);
+
+    updateSettingsVar();
+    buildSemanticIndex();
 }
 
+
 /**
- * Format QString to QList<QString> for the function execAction(QList<QString> cmd)
+ * Add a plugin which is not in the plugins folder, used by the benchmarks.
+ * Its rules are compiled without the rule cache.
+ *
+ * @param plug the plugin, it must stay valid while the engine uses it
+ */
+void Engine::addPlugin(PluginInterfaceV2 *plug)
+{
+    connectPlugin(plug);
+
+    RuleSet rules = RuleSet::compile(plug->pluginId(), plug->getDataXml(), plug->getCommande(), QByteArray());
+    pluginProp.append(rules.commands);
+    conversation->prop.append(rules.commands);
+
+    listPlugins.append(plug);
+    listRules.append(rules);
+    registerPluginActions(plug);
+
+    matchCache.clear();
+    conversation->speculativeText.clear();
+    conversation->speculativeCommands.clear();
+    conversation->speculativeMatches.clear();
+    spellCorrector.build(listRules);
+    buildSemanticIndex();
+}
+
+/**
+ * Connect the signals of a plugin to the engine
+ *
+ * @param plug the plugin
+ */
+void Engine::connectPlugin(PluginInterfaceV2 *plug)
+{
+    // The plugins are shared by the engines of the daemon mode
+    if (isWorker) {
+        new PluginRelay(this, plug);
+        return;
+    }
+
+    connect(plug->getObject(), SIGNAL(sendMessage(QString,bool,QString,QString,QList<QString>,QList<QString>)), this, SLOT(sendReply(QString,bool,QString,QString,QList<QString>,QList<QString>)));
+    connect(plug->getObject(), SIGNAL(showQml(QString,QString)), this, SLOT(showQml(QString,QString)));
+    connect(plug->getObject(), SIGNAL(sendMessageToQml(QString)), this, SLOT(receiveMessageSendedToQml(QString)));
+    connect(plug->getObject(), SIGNAL(execAction(QString)), this, SLOT(pluginActionRequested(QString)));
+    if (!isWorker) connect(this, SIGNAL(signalSendMessageToPlugin(QString,QString)), plug->getObject(), SLOT(messageReceived(QString,QString)));
+}
+
+/**
+ * Execute an action sent by the interface or the session replayer
+ *
  * @param action the QString
  */
 void Engine::executeAction(QString action)
 {
+    execActionText(action, true);
+}
+
+/**
+ * Execute an action sent by a plugin with its execAction(QString) signal, which records no hop
+ *
+ * @param action the QString
+ */
+void Engine::pluginActionRequested(QString action)
+{
+    execActionText(action, false);
+}
+
+/**
+ * Format QString to QList<QString> for the function execAction(QList<QString> cmd)
+ *
+ * @param action the QString
+ * @param isHop if the sender recorded a hop with Tracer::hopSent("action"), the workers are called
+ *              directly by the daemon mode and record no hop
+ */
+void Engine::execActionText(const QString &action, bool isHop)
+{
+    TRACE_SPAN("action", "engine");
+    TRACE_ARG("action", action);
+    if (isHop && !isWorker) Tracer::hopReceived("action");
+
+    if (isIdleWorker()) return;
+
+    conversation->requestId++;
+    QMutexLocker locker(pluginLock());
+
     if (!execAction(formatAction(action))) {
-        foreach (PluginInterface *plug , listPlugins) {
-            if (plug->pluginId() == idOfActualPlugin) {
+        foreach (PluginInterfaceV2 *plug , listPlugins) {
+            if (plug->pluginId() == conversation->idOfActualPlugin) {
+                LagMonitor::setPlugin(conversation->idOfActualPlugin);
+                ALLOCATION_STAGE(PluginCall);
+                setCaller(plug);
                 plug->execAction(formatAction(action));
+                LagMonitor::setPlugin(QString());
             }
         }
     }
@@ -1382,6 +1707,10 @@ void Engine::executeAction(QString action)
  */
 void Engine::handleNetworkData(QNetworkReply *networkReply)
 {
+    TRACE_SPAN("suggestions", "engine");
+
+    perfStats.recordSuggestion(perfStats.now() - networkReply->property("requestTime").toLongLong());
+
     if (networkReply->error() == QNetworkReply::NoError) {
         QByteArray response(networkReply->readAll());
         QXmlStreamReader xml(response);
@@ -26,56 +26,134 @@
 #include <QtCore>
 
 #include "plugininterface.h"
+#include "pluginadapter.h"
+#include "ruleset.h"
+#include "rulecache.h"
+#include "matchcache.h"
+#include "spellcorrector.h"
+#include "semanticindex.h"
+#include "slotparser.h"
+#include "actiontable.h"
+#include "actionqueue.h"
+#include "conversation.h"
+#include "allocationstats.h"
+#include "perfstats.h"
+#include "requestarena.h"
+#include "reply.h"
+#include "tracer.h"
 
 #define key_settings_name "settings_name"
 #define key_settings_sound "settings_sound"
 #define key_settings_proposition "settings_proposition"
+#define key_settings_semantic "settings_semantic"
+
+/**
+ * What the engine understood for one command of the user input, see Engine::understand
+ */
+struct CommandResult
+{
+    QString command;
+    QString pluginId;
+    int item = -1;
+    QString itemId;
+    QList<QString> replies;
+};
 
 class Engine : public QObject
 {
     Q_OBJECT
+    friend class EngineBenchmark;
+    friend class PluginRelay;
+
 public:
     explicit Engine(QObject *parent = nullptr);
+    explicit Engine(const Engine *source, QObject *parent = nullptr);
+    ~Engine();
+
+    QList<CommandResult> understand(const QString &text);
+    void addPlugin(PluginInterfaceV2 *plug);
+
+    Conversation newConversation() const;
+    void setConversation(Conversation *conversation);
+    void setWorkerMode();
+
+    quint64 matchCacheHits() const;
+    quint64 matchCacheMisses() const;
+    QHash<QString, ActionTiming> actionTimings() const;
+    QHash<QString, BatchTiming> batchTimings() const;
+    QVariantMap statistics() const;
 
 private:
     bool execAction(QList<QString> cmd);
-    void format(QString text);
+    void execActionText(const QString &action, bool isHop);
+    void registerActions();
+    void registerPluginActions(PluginInterfaceV2 *plug);
+    void connectPlugin(PluginInterfaceV2 *plug);
+    void actionStats();
+    void actionNotify(const ActionArgs &args);
+    void actionWebSearch(const ActionArgs &args, Reply::Type type);
+    void actionWebSite(const ActionArgs &args, Reply::Type type);
+    QList<QList<QString>> format(QString text) const;
     void analize(QList<QList<QString>> array_cmd);
     void analizeAllPlugins(QList<QList<QString>> array_cmd, QList<QString> cmd);
     bool analizePlugin(QList<QList<QString>> array_cmd, QList<QString> cmd);
+    bool analizeNativeMatchers(const QList<QString> &cmd);
+    RuleMatch matchAllPlugins(const QList<QString> &cmd) const;
+    RuleMatch matchRules(const QList<QString> &cmd) const;
+    RuleMatch matchSemantic(const QList<QString> &cmd) const;
+    void buildSemanticIndex();
+    bool execMatch(const RuleMatch &match, const QList<QString> &cmd, bool isFin);
+    bool execReplyBlock(const RuleBlock &block, bool isFin, const QString &id);
+    void execActionBlock(const RuleBlock &block, PluginInterfaceV2 *plug, bool isConversation);
+    void runEngineAction(const QList<QString> &cmd);
+    bool isConditionTrue(const RuleCondition &condition);
+    void setVar(const RuleVar &ruleVar, const QString &value);
+    void clearVars();
     void updateSettingsVar();
     QString readVarInText(QString text, QList<QString> var);
     QList<QString> formatAction(QString action);
+    void emitReply(const Reply &reply, const QString &id);
+    void recordMatch(const QString &pluginId, int item, const QString &itemId, const QList<QString> &cmd);
+    bool isWebSearchInstalled() const;
+    bool isIdleWorker() const;
+    void setCaller(const PluginInterfaceV2 *plug) const;
+    QRecursiveMutex *pluginLock() const;
 
     QDomDocument doc;
     QSettings settings;
     QString userName = "Inconnu";
     bool soundEnabled = true;
     bool propEnabled = true;
-    QList<PluginInterface *> listPlugins;
-    QList<QString> prop;
-    QList<QString> main_prop;
-    QList<QString> mainVolatil_prop;
-    QList<QString> showedProp;
-    int removePropNuber = 0;
-
-    QList<QString> var;
-
-    QString nextReplyPluginName = "";
-    QString nextReplyNeedId = "";
-    QString nextReplyItemId = "";
-
-    QString idOfActualPlugin = "";
+    bool semanticEnabled = false;
+    QList<PluginInterfaceV2 *> listPlugins;
+    QList<PluginV1Adapter *> listV1Adapters;
+    QList<RuleSet> listRules;
+    ActionTable actionTable;
+    ActionQueue actionQueue;
+    PerfStats perfStats;
+    mutable RequestArena arena;
+    MatchCache matchCache;
+    SpellCorrector spellCorrector;
+    SemanticIndex semanticIndex;
+    QList<QString> pluginProp;
+    QList<QString> pluginMainProp;
+
+    Conversation ownConversation;
+    Conversation *conversation = &ownConversation;
+    bool isWorker = false;
+
+    QList<CommandResult> *recording = nullptr;
 
     QNetworkAccessManager googleSuggestNetworkManager;
-    bool isGoogleSuggest = false;
+
+    QTimer speculationTimer;
 
 signals:
-    void reponseSended(QString reponse, bool isFin, QString typeMessage, QList<QString> url, QList<QString> textUrl);
+    void reponseSended(const Reply &reply);
     void addProp(QString prop);
     void removeAllProp();
     void removeProp(int index);
-    void showQmlFile(QString qmlUrl);
+    void showQmlSource(QString qml, QString id);
     void pluginTrouved(QString name);
     void signalSendMessageToPlugin(QString message, QString pluginId);
     void pluginToQml(QString message, QString pluginId);
@@ -84,13 +162,21 @@ signals:
     void showHomeScreen();
     void previousPage();
     void sendNotify(QString title, QString text, QString action);
+    void openUrl(const QUrl &url);
+    void quitRequested();
+    void actionExecuted(const QString &pluginId, const QString &action, qint64 nsecs);
+    void statisticsSended(const QVariantMap &stats);
+    void pluginSignalAfterRequest(const QString &session, const std::function<void()> &slot);
 
 public slots:
     void messageReceived(QString message);
     void textChanged(QString text);
+    void speculate();
+    void runActions();
     void addBaseProp();
     void showQml(QString qml, QString id);
     void getAllPlugin();
+    void getStatistics();
     void sendReply(
             QString reply, bool isFin, QString typeMessage, QString id, QList<QString> url = QList<QString>(),
             QList<QString> textUrl = QList<QString>()
@@ -100,6 +186,7 @@ public slots:
     void removePlugin(QString id);
     void scanPlugin();
     void executeAction(QString action);
+    void pluginActionRequested(QString action);
     void handleNetworkData(QNetworkReply *networkReply);
 
 };
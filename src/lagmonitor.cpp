@@ -0,0 +1,177 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "lagmonitor.h"
+
+LagMonitor *LagMonitor::instance = nullptr;
+thread_local LagProbe *LagMonitor::currentProbe = nullptr;
+
+/**
+ * Start the probes in a thread of the monitor
+ *
+ * @param threshold the delay in ms from which a thread is reported as blocked
+ */
+LagMonitor::LagMonitor(int threshold) : threshold(threshold), timer(new QTimer)
+{
+    monitorThread.setObjectName("lag monitor");
+    clock.start();
+
+    timer->setInterval(Interval);
+    timer->moveToThread(&monitorThread);
+    QObject::connect(timer, &QTimer::timeout, timer, [this]() { check(); });
+    QObject::connect(&monitorThread, &QThread::started, timer, QOverload<>::of(&QTimer::start));
+    QObject::connect(&monitorThread, &QThread::finished, timer, &QObject::deleteLater);
+
+    instance = this;
+    monitorThread.start();
+}
+
+LagMonitor::~LagMonitor()
+{
+    monitorThread.quit();
+    monitorThread.wait();
+
+    QMutexLocker locker(&mutex);
+    instance = nullptr;
+
+    foreach (LagProbe *probe , probes) {
+        if (probe->thread == QThread::currentThread()) currentProbe = nullptr;
+        delete probe->receiver;
+    }
+
+    qDeleteAll(probes);
+}
+
+/**
+ * Measure the delay of the event loop of a thread, nothing is done if no monitor is running
+ *
+ * @param thread the thread
+ * @param name the name of the thread in the reports
+ */
+void LagMonitor::watch(QThread *thread, const QString &name)
+{
+    if (!instance) return;
+
+    LagProbe *probe = new LagProbe;
+    probe->name = name;
+    probe->thread = thread;
+    probe->receiver = new QObject;
+    probe->receiver->moveToThread(thread);
+
+    QMutexLocker locker(&instance->mutex);
+    instance->probes.append(probe);
+}
+
+/**
+ * Stop watching a thread, called by the thread itself or once it is finished
+ */
+void LagMonitor::unwatch(QThread *thread)
+{
+    if (!instance) return;
+
+    QMutexLocker locker(&instance->mutex);
+
+    for (int i = instance->probes.length()-1; i >= 0; i--) {
+        LagProbe *probe = instance->probes.at(i);
+        if (probe->thread != thread) continue;
+
+        if (thread == QThread::currentThread()) currentProbe = nullptr;
+
+        // The queued probe is removed with its receiver
+        delete probe->receiver;
+        delete instance->probes.takeAt(i);
+    }
+}
+
+/**
+ * @return the delays of the event loops in ms by thread name: count, mean, p50, p90, p99 and max
+ */
+QVariantMap LagMonitor::statistics()
+{
+    QVariantMap stats;
+    if (!instance) return stats;
+
+    QMutexLocker locker(&instance->mutex);
+
+    foreach (LagProbe *probe , instance->probes)
+        stats.insert(probe->name, probe->lags.summary(1e6));
+
+    return stats;
+}
+
+/**
+ * Set the plugin called by the current thread, an empty id when the call is finished
+ */
+void LagMonitor::setPlugin(const QString &pluginId)
+{
+    if (!currentProbe || !instance) return;
+
+    QMutexLocker locker(&instance->mutex);
+    currentProbe->pluginId = pluginId;
+}
+
+/**
+ * Called by the timer: queue a probe in the threads whose last probe has been
+ * dispatched, report the threads whose probe waits for more than the threshold
+ */
+void LagMonitor::check()
+{
+    QMutexLocker locker(&mutex);
+    qint64 now = clock.nsecsElapsed();
+
+    foreach (LagProbe *probe , probes) {
+        if (!probe->isPending) {
+            probe->isPending = true;
+            probe->isReported = false;
+            probe->sentAt = now;
+
+            QMetaObject::invokeMethod(probe->receiver, [this, probe]() { received(probe); }, Qt::QueuedConnection);
+        }
+        else if (!probe->isReported && (now - probe->sentAt) / 1000000 >= threshold) {
+            probe->isReported = true;
+            qWarning("Event loop of the %s thread blocked for %lld ms, %s", qPrintable(probe->name),
+                     (now - probe->sentAt) / 1000000, qPrintable(describe(probe)));
+        }
+    }
+}
+
+/**
+ * Called in the watched thread when its probe is dispatched
+ */
+void LagMonitor::received(LagProbe *probe)
+{
+    currentProbe = probe;
+
+    QMutexLocker locker(&mutex);
+    qint64 lag = clock.nsecsElapsed() - probe->sentAt;
+
+    probe->lags.record(lag);
+    probe->isPending = false;
+
+    if (probe->isReported)
+        qWarning("Event loop of the %s thread unblocked after %lld ms", qPrintable(probe->name), lag / 1000000);
+}
+
+/**
+ * @return the active stage and plugin of a thread, the mutex must be locked
+ */
+QString LagMonitor::describe(LagProbe *probe)
+{
+    const char *stage = probe->stage.load(std::memory_order_relaxed);
+
+    return QString("stage: %1, plugin: %2").arg(stage ? stage : "none", probe->pluginId.isEmpty() ? "none" : probe->pluginId);
+}
@@ -0,0 +1,97 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#ifndef LAGMONITOR_H
+#define LAGMONITOR_H
+
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+#include <QMutex>
+#include <QList>
+#include <QString>
+#include <QVariantMap>
+#include <QElapsedTimer>
+#include <atomic>
+
+#include "perfstats.h"
+
+/**
+ * The event loop of a thread watched by LagMonitor
+ */
+struct LagProbe
+{
+    QString name;
+    QThread *thread = nullptr;
+    QObject *receiver = nullptr;
+    std::atomic<const char *> stage{nullptr};
+    QString pluginId;
+    qint64 sentAt = 0;
+    bool isPending = false;
+    bool isReported = false;
+    Histogram lags;
+};
+
+/**
+ * Measure the delay of the event loops of the interface and of the engine.
+ *
+ * Every Interval ms a probe is queued in each watched thread and the time until
+ * it is dispatched is added to a histogram. When a probe waits more than the
+ * threshold, the thread is reported as blocked with its active stage (the innermost
+ * TRACE_SPAN) and the id of the plugin it is calling, then again when it recovers.
+ */
+class LagMonitor
+{
+public:
+    enum { Interval = 100, Threshold = 250 };
+
+    explicit LagMonitor(int threshold = Threshold);
+    ~LagMonitor();
+
+    static void watch(QThread *thread, const QString &name);
+    static void unwatch(QThread *thread);
+    static QVariantMap statistics();
+
+    static inline const char *enterStage(const char *stage)
+    {
+        return currentProbe ? currentProbe->stage.exchange(stage, std::memory_order_relaxed) : nullptr;
+    }
+
+    static inline void leaveStage(const char *previous)
+    {
+        if (currentProbe) currentProbe->stage.store(previous, std::memory_order_relaxed);
+    }
+
+    static void setPlugin(const QString &pluginId);
+
+private:
+    void check();
+    void received(LagProbe *probe);
+    static QString describe(LagProbe *probe);
+
+    static LagMonitor *instance;
+    static thread_local LagProbe *currentProbe;
+
+    int threshold;
+    QThread monitorThread;
+    QTimer *timer;
+    QElapsedTimer clock;
+    mutable QMutex mutex;
+    QList<LagProbe *> probes;
+};
+
+#endif // LAGMONITOR_H
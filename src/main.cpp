@@ -22,7 +22,11 @@
 #include <QtQml/QQmlContext>
 #include <QTranslator>
 #include <QDir>
+#include <QFile>
 #include <QCommandLineParser>
+#include <QThread>
+#include <QScopedPointer>
+#include <QElapsedTimer>
 
 #ifndef QT_NO_WIDGETS
 #include <QtWidgets/QApplication>
@@ -34,11 +38,166 @@ typedef QGuiApplication Application;
 
 #include "swiftyworker.h"
 #include "plugininterface.h"
+#include "batchrunner.h"
+#include "sessionreplayer.h"
+#include "sessionserver.h"
+#include "tracer.h"
+#include "lagmonitor.h"
+#include "perfresults.h"
 
 #ifndef QT_NO_SYSTEMTRAYICON
 
+/**
+ * Add the options of Swifty Assistant to the command line parser
+ */
+static void addOptions(QCommandLineParser &parser)
+{
+    parser.setApplicationDescription("Swifty Assistant is a simple, user-friendly, personal assistant based on an extension system.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addOption(QCommandLineOption("batch", "Analize the utterances of <file> (- for stdin) and write the results as JSON lines, without interface.", "file"));
+    parser.addOption(QCommandLineOption("jobs", "Number of engines used by the batch mode (1 by default) and the daemon mode (one per core by default).", "n", "1"));
+    parser.addOption(QCommandLineOption("daemon", "Serve the sessions of several clients on the local socket <name>, without interface.", "name"));
+    parser.addOption(QCommandLineOption("record", "Record the keystrokes, the messages and the actions in <file>.", "file"));
+    parser.addOption(QCommandLineOption("replay", "Replay a recording in the engine without interface and print the latencies.", "file"));
+    parser.addOption(QCommandLineOption("speed", "Speed of the replay: original or max.", "speed", "original"));
+    parser.addOption(QCommandLineOption("results", "Write the results of the replay, or of the startup of the interface and of the first web view, in <file>, for tools/perfbaseline.", "file"));
+    parser.addOption(QCommandLineOption("lag-threshold", "Report the event loops blocked for more than <ms>, 0 to disable the monitor.", "ms", QString::number(LagMonitor::Threshold)));
+    parser.addOption(QCommandLineOption("web-prewarm", "Start the web engine <ms> after the window is shown, 0 to start it with the first web reply.", "ms", "0"));
+    parser.addOption(QCommandLineOption("web-views", "Keep at most <n> web views to reuse them, the least recently used are destroyed first.", "n", "2"));
+    parser.addOption(QCommandLineOption("web-memory", "Discard the hidden web views when the assistant and its web processes use more than <MiB>, 0 for no budget.", "MiB", "0"));
+    parser.addOption(QCommandLineOption("trace", "Write a Chrome trace of the engine in <file>, also enabled by SWIFTY_TRACE=<file>.", "file"));
+}
+
+/**
+ * Start the tracing if it is requested, the trace is written when the application quits
+ */
+static void startTracing(const QCommandLineParser &parser)
+{
+    QString fileName = parser.isSet("trace") ? parser.value("trace") : qEnvironmentVariable("SWIFTY_TRACE");
+    if (fileName.isEmpty()) return;
+
+    QThread::currentThread()->setObjectName("main");
+    Tracer::start(fileName);
+}
+
+/**
+ * The batch, replay and daemon modes do not create the interface, so the arguments are read before the application is created
+ *
+ * @param option the name of the option, "batch" for --batch
+ */
+static bool hasOption(int argc, char *argv[], const char *option)
+{
+    QByteArray name = QByteArray("--")+option;
+
+    for (int i = 1; i < argc; i++) {
+        if (name == argv[i] || QByteArray(argv[i]).startsWith(name+"=")) return true;
+    }
+
+    return false;
+}
+
+/**
+ * Run the batch mode
+ *
+ * @return the exit code
+ */
+static int runBatch(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    addOptions(parser);
+    parser.process(app);
+    startTracing(parser);
+
+    QFile input;
+    QString fileName = parser.value("batch");
+    bool isOpen;
+
+    if (fileName == "-") {
+        isOpen = input.open(stdin, QIODevice::ReadOnly);
+    }
+    else {
+        input.setFileName(fileName);
+        isOpen = input.open(QIODevice::ReadOnly);
+    }
+
+    if (!isOpen) {
+        qCritical("Cannot open %s", qPrintable(fileName));
+        return 1;
+    }
+
+    QFile output;
+    output.open(stdout, QIODevice::WriteOnly);
+
+    BatchRunner runner(parser.value("jobs").toInt());
+    return runner.run(&input, &output);
+}
+
+/**
+ * Run the daemon mode
+ *
+ * @return the exit code
+ */
+static int runDaemon(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    addOptions(parser);
+    parser.process(app);
+    startTracing(parser);
+
+    SessionServer server(parser.isSet("jobs") ? parser.value("jobs").toInt() : QThread::idealThreadCount());
+    if (!server.listen(parser.value("daemon"))) return 1;
+
+    return app.exec();
+}
+
+/**
+ * Run the replay mode
+ *
+ * @return the exit code
+ */
+static int runReplay(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    addOptions(parser);
+    parser.process(app);
+    startTracing(parser);
+
+    QFile input(parser.value("replay"));
+    if (!input.open(QIODevice::ReadOnly)) {
+        qCritical("Cannot open %s", qPrintable(input.fileName()));
+        return 1;
+    }
+
+    QFile output;
+    output.open(stdout, QIODevice::WriteOnly);
+
+    QScopedPointer<LagMonitor> monitor;
+    if (parser.value("lag-threshold").toInt() > 0) monitor.reset(new LagMonitor(parser.value("lag-threshold").toInt()));
+
+    SessionReplayer replayer(parser.value("speed") == "max" ? SessionReplayer::Max : SessionReplayer::Original);
+    int exitCode = replayer.run(SessionRecorder::load(&input), &output);
+
+    if (parser.isSet("results")) {
+        PerfResults results;
+        replayer.addResults(results);
+        if (!results.save(parser.value("results"))) return 1;
+    }
+
+    return exitCode;
+}
+
 int main(int argc, char *argv[])
 {
+    QElapsedTimer startup;
+    startup.start();
+
     Q_INIT_RESOURCE(res);
 
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -47,6 +206,13 @@ int main(int argc, char *argv[])
     QCoreApplication::setApplicationName("Swifty Assistant");
     QCoreApplication::setOrganizationName("swiftapp");
     QCoreApplication::setApplicationVersion("v1.0.0-alpha4");
+
+    if (hasOption(argc, argv, "batch")) return runBatch(argc, argv);
+    if (hasOption(argc, argv, "replay")) return runReplay(argc, argv);
+    if (hasOption(argc, argv, "daemon")) return runDaemon(argc, argv);
+
+    // Only shares the OpenGL contexts, it must be done before the application is created.
+    // Chromium and the web profile are started by the first web view, see WebViewPool.qml
     QtWebEngine::initialize();
 
     Application app(argc, argv);
@@ -54,10 +220,16 @@ int main(int argc, char *argv[])
     //Command line tools
     QCommandLineParser parser;
 
-    parser.setApplicationDescription("Swifty Assistant is a simple, user-friendly, personal assistant based on an extension system.");
-    parser.addHelpOption();
-    parser.addVersionOption();
+    addOptions(parser);
     parser.process(app);
+    startTracing(parser);
+
+    if (parser.isSet("record")) SwiftyWorker::setRecordFile(parser.value("record"));
+    SwiftyWorker::setWebPrewarm(parser.value("web-prewarm").toInt());
+    SwiftyWorker::setWebPool(parser.value("web-views").toInt(), parser.value("web-memory").toInt());
+
+    PerfResults results;
+    if (parser.isSet("results")) SwiftyWorker::setResults(&results);
 
     //Load translation files
     QString locale = QLocale::system().name().section('_', 0, 0);
@@ -81,12 +253,35 @@ int main(int argc, char *argv[])
         return 1;
     }
 
+    //Measure the delays of the event loops
+    QScopedPointer<LagMonitor> monitor;
+    if (parser.value("lag-threshold").toInt() > 0) {
+        monitor.reset(new LagMonitor(parser.value("lag-threshold").toInt()));
+        LagMonitor::watch(QThread::currentThread(), "GUI");
+    }
+
     //Run app
     QQmlApplicationEngine appEngine;
     SwiftyWorker::declareQML();
+
+    QObject::connect(&appEngine, &QQmlApplicationEngine::objectCreated, [&startup, &results](QObject *object, const QUrl &) {
+        if (object == nullptr) return;
+
+        qint64 memory = PerfResults::residentMemory();
+        qInfo("Interface created in %lld ms, resident memory %lld MiB", startup.elapsed(), memory / (1024*1024));
+
+        results.add("startup.interface", startup.elapsed(), "ms");
+        results.add("startup.rss", memory / (1024.0*1024.0), "MiB");
+    });
+
     appEngine.load(QUrl("qrc:/main.qml"));
 
-    return app.exec();
+    int exitCode = app.exec();
+
+    // The first web view is in the results if it has been created before the application quits
+    if (parser.isSet("results") && !results.save(parser.value("results"))) return 1;
+
+    return exitCode;
 }
 
 #endif
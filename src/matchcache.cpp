@@ -0,0 +1,78 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "matchcache.h"
+
+MatchCache::MatchCache(int capacity) : cache(capacity)
+{
+}
+
+/**
+ * Search a command in the cache
+ *
+ * @param cmd the words list of the command
+ * @param match the cached result
+ * @return if the command is in the cache
+ */
+bool MatchCache::find(const QList<QString> &cmd, RuleMatch *match)
+{
+    RuleMatch *cached = cache.object(key(cmd));
+
+    if (cached == nullptr) {
+        missCount++;
+        return false;
+    }
+
+    hitCount++;
+    *match = *cached;
+
+    return true;
+}
+
+/**
+ * Add the result of the analysis of a command, the least recently used command is removed when the cache is full
+ *
+ * @param cmd the words list of the command
+ * @param match the item found or an invalid RuleMatch
+ */
+void MatchCache::insert(const QList<QString> &cmd, const RuleMatch &match)
+{
+    cache.insert(key(cmd), new RuleMatch(match));
+}
+
+/**
+ * Remove all the commands, called when the list of plugins changes
+ */
+void MatchCache::clear()
+{
+    cache.clear();
+}
+
+quint64 MatchCache::hits() const
+{
+    return hitCount;
+}
+
+quint64 MatchCache::misses() const
+{
+    return missCount;
+}
+
+QString MatchCache::key(const QList<QString> &cmd)
+{
+    return cmd.join(QChar(0x1F));
+}
@@ -0,0 +1,64 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#ifndef MATCHCACHE_H
+#define MATCHCACHE_H
+
+#include <QList>
+#include <QCache>
+#include <QString>
+
+/**
+ * The item of a plugin found for a command
+ */
+struct RuleMatch
+{
+    int plugin = -1;
+    int item = -1;
+    QList<QString> vars;
+    int evaluated = 0; // items checked by the rules to find it
+
+    bool isValid() const { return plugin != -1 && item != -1; }
+};
+
+/**
+ * Least recently used cache of the commands already analized.
+ *
+ * A command which matches no rule is also kept, so a repeated unknown
+ * command goes directly to the web search.
+ */
+class MatchCache
+{
+public:
+    explicit MatchCache(int capacity = 256);
+
+    bool find(const QList<QString> &cmd, RuleMatch *match);
+    void insert(const QList<QString> &cmd, const RuleMatch &match);
+    void clear();
+
+    quint64 hits() const;
+    quint64 misses() const;
+
+private:
+    static QString key(const QList<QString> &cmd);
+
+    QCache<QString, RuleMatch> cache;
+    quint64 hitCount = 0;
+    quint64 missCount = 0;
+};
+
+#endif // MATCHCACHE_H
@@ -0,0 +1,260 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "perfresults.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QSaveFile>
+#include <QFile>
+#include <QDir>
+#include <QHash>
+#include <QCoreApplication>
+
+/**
+ * Add a value to a metric, a metric has a value for each run or repetition
+ *
+ * @param name "<source>.<measure>", like "bench.understand.5x20.time"
+ * @param unit "ns", "ms", "allocs" or "bytes"
+ */
+void PerfResults::add(const QString &name, double value, const QString &unit)
+{
+    Metric &metric = metrics[name];
+    metric.unit = unit;
+    metric.values.append(value);
+}
+
+/**
+ * Add the values of other results, used to build a baseline from several runs
+ */
+void PerfResults::merge(const PerfResults &other)
+{
+    for (auto it = other.metrics.cbegin(); it != other.metrics.cend(); ++it) {
+        Metric &metric = metrics[it.key()];
+        metric.unit = it.value().unit;
+        metric.values.append(it.value().values);
+    }
+}
+
+bool PerfResults::isEmpty() const
+{
+    return metrics.isEmpty();
+}
+
+QList<QString> PerfResults::names() const
+{
+    return metrics.keys();
+}
+
+PerfResults::Metric PerfResults::metric(const QString &name) const
+{
+    return metrics.value(name);
+}
+
+bool PerfResults::contains(const QString &name) const
+{
+    return metrics.contains(name);
+}
+
+QString PerfResults::label() const
+{
+    return resultsLabel;
+}
+
+QDateTime PerfResults::date() const
+{
+    return resultsDate;
+}
+
+/**
+ * @param label the build measured, like the output of git describe
+ */
+void PerfResults::setLabel(const QString &label)
+{
+    resultsLabel = label;
+}
+
+/**
+ * Write the results, the old file is only replaced if the new one is complete
+ *
+ * @return false if the file cannot be written
+ */
+bool PerfResults::save(const QString &fileName) const
+{
+    QJsonObject jsonMetrics;
+
+    for (auto it = metrics.cbegin(); it != metrics.cend(); ++it) {
+        QJsonArray values;
+        for (double value : it.value().values) values.append(value);
+
+        QJsonObject metric;
+        metric.insert("unit", it.value().unit);
+        metric.insert("values", values);
+        jsonMetrics.insert(it.key(), metric);
+    }
+
+    QJsonObject object;
+    object.insert("format", "swifty-perf");
+    object.insert("version", Version);
+    object.insert("label", resultsLabel);
+    object.insert("date", resultsDate.toString(Qt::ISODate));
+    object.insert("metrics", jsonMetrics);
+
+    QSaveFile file(fileName);
+    QByteArray data = QJsonDocument(object).toJson();
+
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        qCritical("Cannot write %s", qPrintable(fileName));
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Read results or a baseline
+ *
+ * @param results replaced by the content of the file
+ * @return false if the file cannot be read, is not valid or has a newer version
+ */
+bool PerfResults::load(const QString &fileName, PerfResults &results)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCritical("Cannot open %s", qPrintable(fileName));
+        return false;
+    }
+
+    QJsonObject object = QJsonDocument::fromJson(file.readAll()).object();
+
+    if (object.value("format").toString() != "swifty-perf") {
+        qCritical("%s is not a performance result", qPrintable(fileName));
+        return false;
+    }
+    if (object.value("version").toInt() > Version) {
+        qCritical("%s has the version %d, this build reads up to the version %d", qPrintable(fileName), object.value("version").toInt(), int(Version));
+        return false;
+    }
+
+    results = PerfResults();
+    results.resultsLabel = object.value("label").toString();
+    results.resultsDate = QDateTime::fromString(object.value("date").toString(), Qt::ISODate);
+
+    QJsonObject jsonMetrics = object.value("metrics").toObject();
+
+    for (auto it = jsonMetrics.constBegin(); it != jsonMetrics.constEnd(); ++it) {
+        QJsonObject jsonMetric = it.value().toObject();
+
+        Metric metric;
+        metric.unit = jsonMetric.value("unit").toString();
+        foreach (QJsonValue value , jsonMetric.value("values").toArray()) metric.values.append(value.toDouble());
+
+        results.metrics.insert(it.key(), metric);
+    }
+
+    return true;
+}
+
+/**
+ * Exact percentile of the values measured by a run, used by the replay mode and the load generator.
+ * Histogram::percentile gives the same with the buckets of the statistics of the engine.
+ *
+ * @param sorted the values in ascending order, not empty
+ * @param p from 0 to 100
+ * @return the value at the nearest rank below the percentile
+ */
+qint64 PerfResults::percentile(const QVector<qint64> &sorted, int p)
+{
+    return sorted.at((sorted.length()-1) * p / 100);
+}
+
+/**
+ * @param pid the process, "self" for this one
+ * @param field "VmHWM:", "VmRSS:" or "PPid:"
+ * @return the value of a field of /proc/<pid>/status, the memory is in kB, -1 if the system does not give it
+ */
+static qint64 statusField(const QString &pid, const QByteArray &field)
+{
+#ifdef Q_OS_LINUX
+    QFile status("/proc/" + pid + "/status");
+    if (!status.open(QIODevice::ReadOnly | QIODevice::Text)) return -1;
+
+    // VmHWM:     123456 kB
+    foreach (QByteArray line , status.readAll().split('\n')) {
+        if (line.startsWith(field)) return line.mid(field.length()).trimmed().split(' ').first().toLongLong();
+    }
+#else
+    Q_UNUSED(pid)
+    Q_UNUSED(field)
+#endif
+
+    return -1;
+}
+
+static qint64 statusMemory(const QByteArray &field)
+{
+    qint64 kiB = statusField("self", field);
+    return kiB < 0 ? -1 : kiB * 1024;
+}
+
+/**
+ * @return the maximum resident memory of the process in bytes, -1 if the system does not give it
+ */
+qint64 PerfResults::peakRss()
+{
+    return statusMemory("VmHWM:");
+}
+
+/**
+ * @return the resident memory of the process in bytes, -1 if the system does not give it
+ */
+qint64 PerfResults::residentMemory()
+{
+    return statusMemory("VmRSS:");
+}
+
+/**
+ * Sum the resident memory of the processes started by this one and by its children,
+ * like the zygote and the render processes of the web engine
+ *
+ * @return the memory in bytes, 0 if there is no child, -1 if the system does not give it
+ */
+qint64 PerfResults::descendantsMemory()
+{
+#ifdef Q_OS_LINUX
+    QMultiHash<qint64, qint64> children;
+    foreach (QString entry , QDir("/proc").entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        bool isPid = false;
+        qint64 pid = entry.toLongLong(&isPid);
+        if (isPid) children.insert(statusField(entry, "PPid:"), pid);
+    }
+
+    qint64 kiB = 0;
+    QList<qint64> parents = {QCoreApplication::applicationPid()};
+    while (!parents.isEmpty()) {
+        foreach (qint64 pid , children.values(parents.takeFirst())) {
+            kiB += qMax(0LL, statusField(QString::number(pid), "VmRSS:"));
+            parents.append(pid);
+        }
+    }
+
+    return kiB * 1024;
+#else
+    return -1;
+#endif
+}
@@ -0,0 +1,73 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#ifndef PERFRESULTS_H
+#define PERFRESULTS_H
+
+#include <QString>
+#include <QList>
+#include <QMap>
+#include <QVector>
+#include <QDateTime>
+
+/**
+ * Performance results saved as JSON, written by the benchmarks and the replay mode and
+ * compared by tools/perfbaseline. A baseline is the same file with the values of several runs.
+ *
+ * {"format": "swifty-perf", "version": 1, "label": "...", "date": "...",
+ *  "metrics": {"replay.message.p90": {"unit": "ms", "values": [1.2, 1.3]}, ...}}
+ *
+ * Every metric is better when it is lower: latencies, times, allocations or memory.
+ */
+class PerfResults
+{
+public:
+    enum { Version = 1 };
+
+    struct Metric
+    {
+        QString unit;
+        QVector<double> values;
+    };
+
+    void add(const QString &name, double value, const QString &unit);
+    void merge(const PerfResults &other);
+
+    bool isEmpty() const;
+    QList<QString> names() const;
+    Metric metric(const QString &name) const;
+    bool contains(const QString &name) const;
+
+    QString label() const;
+    QDateTime date() const;
+    void setLabel(const QString &label);
+
+    bool save(const QString &fileName) const;
+    static bool load(const QString &fileName, PerfResults &results);
+
+    static qint64 percentile(const QVector<qint64> &sorted, int p);
+    static qint64 peakRss();
+    static qint64 residentMemory();
+    static qint64 descendantsMemory();
+
+private:
+    QString resultsLabel;
+    QDateTime resultsDate = QDateTime::currentDateTimeUtc();
+    QMap<QString, Metric> metrics;
+};
+
+#endif // PERFRESULTS_H
@@ -0,0 +1,217 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "perfstats.h"
+
+#include <QtAlgorithms>
+#include <cmath>
+
+//===================================================
+//==================== Histogram ====================
+//===================================================
+
+void Histogram::record(qint64 value)
+{
+    if (value < 0) value = 0;
+
+    int index = bucket(value);
+    if (index >= buckets.length()) buckets.resize(index+1);
+
+    buckets[index]++;
+    total++;
+    sum += value;
+    maxValue = qMax(maxValue, value);
+}
+
+void Histogram::clear()
+{
+    buckets.clear();
+    total = 0;
+    maxValue = 0;
+    sum = 0;
+}
+
+quint64 Histogram::count() const
+{
+    return total;
+}
+
+qint64 Histogram::max() const
+{
+    return maxValue;
+}
+
+double Histogram::mean() const
+{
+    return total == 0 ? 0 : sum / total;
+}
+
+/**
+ * @param p the percentile, 50 for the median
+ * @return the upper bound of the bucket containing the percentile, 0 if the histogram is empty
+ */
+qint64 Histogram::percentile(double p) const
+{
+    if (total == 0) return 0;
+
+    quint64 rank = quint64(std::ceil(p / 100 * total));
+    quint64 seen = 0;
+
+    for (int i = 0; i < buckets.length(); i++) {
+        seen += buckets.at(i);
+        if (seen >= rank && seen > 0) return qMin(bucketMax(i), maxValue);
+    }
+
+    return maxValue;
+}
+
+/**
+ * @param unit the values are divided by it, 1e6 to get milliseconds from nanoseconds
+ * @return count, mean, p50, p90, p99 and max
+ */
+QVariantMap Histogram::summary(double unit) const
+{
+    QVariantMap summary;
+    summary.insert("count", total);
+    summary.insert("mean", mean() / unit);
+    summary.insert("p50", percentile(50) / unit);
+    summary.insert("p90", percentile(90) / unit);
+    summary.insert("p99", percentile(99) / unit);
+    summary.insert("max", maxValue / unit);
+
+    return summary;
+}
+
+/**
+ * The values under SubBuckets have their own bucket, then each power of two is split in SubBuckets
+ */
+int Histogram::bucket(qint64 value)
+{
+    if (value < SubBuckets) return int(value);
+
+    int exponent = 63 - qCountLeadingZeroBits(quint64(value));
+    int sub = int(value >> (exponent - SubBits)) - SubBuckets;
+
+    return SubBuckets + (exponent - SubBits) * SubBuckets + sub;
+}
+
+qint64 Histogram::bucketMax(int bucket)
+{
+    if (bucket < SubBuckets) return bucket;
+
+    int shift = (bucket - SubBuckets) / SubBuckets;
+    int sub = (bucket - SubBuckets) % SubBuckets;
+
+    return ((qint64(SubBuckets + sub + 1)) << shift) - 1;
+}
+
+//===================================================
+//==================== PerfStats ====================
+//===================================================
+
+PerfStats::PerfStats()
+{
+    clock.start();
+}
+
+/**
+ * @return the time since the start of the engine in nanoseconds
+ */
+qint64 PerfStats::now() const
+{
+    return clock.nsecsElapsed();
+}
+
+/**
+ * Count the items checked for a command of the utterance being analized
+ */
+void PerfStats::addRulesEvaluated(int count)
+{
+    rulesEvaluated += count;
+}
+
+/**
+ * An utterance has been analized
+ *
+ * @param nsecs the time from its reception to its last reply
+ */
+void PerfStats::recordUtterance(qint64 nsecs)
+{
+    utterances.record(nsecs);
+    rules.record(rulesEvaluated);
+    rulesEvaluated = 0;
+}
+
+void PerfStats::recordCompletion(qint64 nsecs)
+{
+    completions.record(nsecs);
+}
+
+void PerfStats::recordSuggestion(qint64 nsecs)
+{
+    suggestions.record(nsecs);
+}
+
+void PerfStats::recordAction(const QString &pluginId, qint64 nsecs)
+{
+    actions[pluginId].record(nsecs);
+}
+
+void PerfStats::recordRuleCache(bool isHit)
+{
+    if (isHit) ruleCacheHits++;
+    else ruleCacheMisses++;
+}
+
+void PerfStats::clear()
+{
+    rulesEvaluated = 0;
+    utterances.clear();
+    rules.clear();
+    completions.clear();
+    suggestions.clear();
+    actions.clear();
+    ruleCacheHits = 0;
+    ruleCacheMisses = 0;
+}
+
+/**
+ * @return the statistics, the times are in milliseconds:
+ *         {uptime, utterances, rules, completions, suggestions, actions: {pluginId: ...}, ruleCache: {hits, misses}}
+ */
+QVariantMap PerfStats::toVariantMap() const
+{
+    QVariantMap stats;
+    stats.insert("uptime", clock.elapsed() / 1000);
+    stats.insert("utterances", utterances.summary(1e6));
+    stats.insert("rules", rules.summary());
+    stats.insert("completions", completions.summary(1e6));
+    stats.insert("suggestions", suggestions.summary(1e6));
+
+    QVariantMap actionStats;
+    for (auto it = actions.constBegin(); it != actions.constEnd(); ++it)
+        actionStats.insert(it.key(), it.value().summary(1e6));
+
+    stats.insert("actions", actionStats);
+
+    QVariantMap ruleCache;
+    ruleCache.insert("hits", ruleCacheHits);
+    ruleCache.insert("misses", ruleCacheMisses);
+    stats.insert("ruleCache", ruleCache);
+
+    return stats;
+}
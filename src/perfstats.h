@@ -0,0 +1,90 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#ifndef PERFSTATS_H
+#define PERFSTATS_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <QVariantMap>
+#include <QElapsedTimer>
+
+/**
+ * Histogram with logarithmic buckets: 8 buckets for each power of two,
+ * so a percentile is known within 12.5 % whatever the number of values.
+ */
+class Histogram
+{
+public:
+    enum { SubBuckets = 8, SubBits = 3 };
+
+    void record(qint64 value);
+    void clear();
+
+    quint64 count() const;
+    qint64 max() const;
+    double mean() const;
+    qint64 percentile(double p) const;
+
+    QVariantMap summary(double unit = 1) const;
+
+private:
+    static int bucket(qint64 value);
+    static qint64 bucketMax(int bucket);
+
+    QVector<quint64> buckets;
+    quint64 total = 0;
+    qint64 maxValue = 0;
+    double sum = 0;
+};
+
+/**
+ * Counters and latency histograms of the engine, displayed by "app stats"
+ * and by the settings. They are only used by the engine thread.
+ */
+class PerfStats
+{
+public:
+    PerfStats();
+
+    qint64 now() const;
+
+    void addRulesEvaluated(int count);
+    void recordUtterance(qint64 nsecs);
+    void recordCompletion(qint64 nsecs);
+    void recordSuggestion(qint64 nsecs);
+    void recordAction(const QString &pluginId, qint64 nsecs);
+    void recordRuleCache(bool isHit);
+    void clear();
+
+    QVariantMap toVariantMap() const;
+
+private:
+    QElapsedTimer clock;
+
+    int rulesEvaluated = 0;
+    Histogram utterances;
+    Histogram rules;
+    Histogram completions;
+    Histogram suggestions;
+    QHash<QString, Histogram> actions;
+    quint64 ruleCacheHits = 0;
+    quint64 ruleCacheMisses = 0;
+};
+
+#endif // PERFSTATS_H
@@ -0,0 +1,58 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "pluginadapter.h"
+
+PluginV1Adapter::PluginV1Adapter(PluginInterface *plugin) : plugin(plugin)
+{
+}
+
+QString PluginV1Adapter::getDataXml() const
+{
+    return plugin->getDataXml();
+}
+
+QString PluginV1Adapter::pluginId() const
+{
+    return plugin->pluginId();
+}
+
+void PluginV1Adapter::execAction(const QList<QString> &cmd)
+{
+    plugin->execAction(cmd);
+}
+
+QList<QString> PluginV1Adapter::getCommande() const
+{
+    return plugin->getCommande();
+}
+
+QObject *PluginV1Adapter::getObject()
+{
+    return plugin->getObject();
+}
+
+/**
+ * Forward a message of the plugin interface to the wrapped plugin
+ *
+ * @param message the message
+ * @param pluginId the id of the plugin actually used
+ */
+void PluginV1Adapter::messageReceived(const QString &message, const QString &pluginId)
+{
+    plugin->messageReceived(message, pluginId);
+}
@@ -0,0 +1,44 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#ifndef PLUGINADAPTER_H
+#define PLUGINADAPTER_H
+
+#include "plugininterface.h"
+
+/**
+ * Wrap a plugin implementing the first version of the interface
+ * so that the engine only works with PluginInterfaceV2
+ */
+class PluginV1Adapter : public PluginInterfaceV2
+{
+public:
+    explicit PluginV1Adapter(PluginInterface *plugin);
+
+    QString getDataXml() const override;
+    QString pluginId() const override;
+    void execAction(const QList<QString> &cmd) override;
+    QList<QString> getCommande() const override;
+    QObject* getObject() override;
+
+    void messageReceived(const QString &message, const QString &pluginId) override;
+
+private:
+    PluginInterface *plugin;
+};
+
+#endif // PLUGINADAPTER_H
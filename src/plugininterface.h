@@ -20,6 +20,7 @@
 
 #include <QObject>
 #include <QString>
+#include <QVariantMap>
 
 class PluginInterface
 {
@@ -42,11 +43,91 @@ public slots:
 };
 
 
+/**
+ * Second version of the plugin interface.
+ *
+ * Arguments are passed by const reference and a plugin can implement
+ * match() to recognize the tokenized user input itself instead of
+ * describing its commands in the xml returned by getDataXml().
+ * Plugins implementing the first version are still loaded.
+ *
+ * New virtual functions are declared after messageReceived() and increase the
+ * version of PluginInterfaceV2_iid, so a plugin built with an older header is
+ * refused instead of being called with another layout.
+ */
+class PluginInterfaceV2
+{
+public:
+    enum { NoMatch = -1 };
+
+    virtual ~PluginInterfaceV2() = default;
+    virtual QString getDataXml() const = 0;
+    virtual QString pluginId() const = 0;
+    virtual void execAction(const QList<QString> &cmd) = 0;
+    virtual QList<QString> getCommande() const = 0;
+    virtual QObject* getObject() = 0;
+
+    /**
+     * Native matcher called with the words of the user command before the xml rules
+     *
+     * @param tokens the words of the command, lower case and without accents
+     * @return a score >= 0 if the plugin handles the command, NoMatch otherwise
+     */
+    virtual int match(const QList<QString> &tokens) const { Q_UNUSED(tokens) return NoMatch; }
+
+    /**
+     * Called when match() returned the best score for the command
+     *
+     * @param tokens the words of the command
+     */
+    virtual void execMatch(const QList<QString> &tokens) { Q_UNUSED(tokens) }
+
+signals:
+    void sendMessage(QString reply, bool isFin, QString typeMessage, QString id, QList<QString> url = QList<QString>(), QList<QString> textUrl = QList<QString>());
+    void sendMessageToQml(QString message);
+    void showQml(QString qml, QString id);
+    void execAction(QString action);
+
+public slots:
+    virtual void messageReceived(const QString &message, const QString &pluginId) = 0;
+
+public:
+    /**
+     * Execute an action of the xml with the <Slot> values of the item found
+     *
+     * @param cmd the words of the action
+     * @param values slot name => number, duration in seconds, QDateTime or text
+     */
+    virtual void execSlotAction(const QList<QString> &cmd, const QVariantMap &values) { Q_UNUSED(values) execAction(cmd); }
+
+    /**
+     * Execute the consecutive actions of an item given to this plugin
+     *
+     * @param cmds the words of each action
+     * @param values slot name => value, see execSlotAction()
+     */
+    virtual void execActions(const QList<QList<QString>> &cmds, const QVariantMap &values)
+    {
+        for (const QList<QString> &cmd : cmds) execSlotAction(cmd, values);
+    }
+
+    /**
+     * Actions of the plugin which can be used in the xml of all the plugins, like the
+     * actions of the engine ("settings name"...). They are given to execAction().
+     *
+     * @return the verb paths, "media pause" for example
+     */
+    virtual QList<QString> hostActions() const { return QList<QString>(); }
+};
+
+
 QT_BEGIN_NAMESPACE
 
 #define PluginInterface_iid "fr.swiftapp.swiftyassistant.plugin"
+#define PluginInterfaceV2_iid "fr.swiftapp.swiftyassistant.plugin/2.1"
 
 Q_DECLARE_INTERFACE(PluginInterface, PluginInterface_iid)
+Q_DECLARE_INTERFACE(PluginInterfaceV2, PluginInterfaceV2_iid)
 
 QT_END_NAMESPACE
 
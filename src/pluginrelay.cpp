@@ -0,0 +1,120 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "pluginrelay.h"
+#include "engine.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QThread>
+
+namespace {
+
+/**
+ * The last call of a plugin
+ */
+struct PluginCaller
+{
+    const Engine *engine = nullptr;
+    QString session;
+};
+
+QMutex callersLock;
+QHash<const PluginInterfaceV2 *, PluginCaller> callers;
+
+}
+
+/**
+ * Connect the signals of a plugin to the relay, the relay is deleted with the engine
+ *
+ * @param engine the engine of the daemon mode
+ * @param plug the plugin
+ */
+PluginRelay::PluginRelay(Engine *engine, PluginInterfaceV2 *plug) : QObject(engine), engine(engine), plug(plug)
+{
+    connect(plug->getObject(), SIGNAL(sendMessage(QString,bool,QString,QString,QList<QString>,QList<QString>)), this, SLOT(sendMessage(QString,bool,QString,QString,QList<QString>,QList<QString>)), Qt::DirectConnection);
+    connect(plug->getObject(), SIGNAL(showQml(QString,QString)), this, SLOT(showQml(QString,QString)), Qt::DirectConnection);
+    connect(plug->getObject(), SIGNAL(sendMessageToQml(QString)), this, SLOT(sendMessageToQml(QString)), Qt::DirectConnection);
+    connect(plug->getObject(), SIGNAL(execAction(QString)), this, SLOT(execAction(QString)), Qt::DirectConnection);
+}
+
+/**
+ * Called by an engine before each call of a plugin, with the lock of the plugins
+ *
+ * @param plug the plugin
+ * @param engine the engine which calls it
+ * @param session the session of the conversation of the engine, empty outside of a session
+ */
+void PluginRelay::setCaller(const PluginInterfaceV2 *plug, const Engine *engine, const QString &session)
+{
+    QMutexLocker locker(&callersLock);
+
+    PluginCaller &caller = callers[plug];
+    caller.engine = engine;
+    caller.session = session;
+}
+
+/**
+ * Give a signal of the plugin to the engine if it is the last one which called the plugin
+ *
+ * @param slot the call of the slot of the engine
+ */
+void PluginRelay::relay(const std::function<void()> &slot)
+{
+    PluginCaller caller;
+
+    {
+        QMutexLocker locker(&callersLock);
+        caller = callers.value(plug);
+    }
+
+    if (caller.engine != engine) return;
+
+    // Only the engine runs in its thread: the signal is sent by the call of its request
+    if (QThread::currentThread() == engine->thread() && !engine->isIdleWorker()) {
+        slot();
+        return;
+    }
+
+    if (caller.session.isEmpty()) return;
+
+    Engine *receiver = engine;
+
+    QMetaObject::invokeMethod(receiver, [receiver, caller, slot]() {
+        emit receiver->pluginSignalAfterRequest(caller.session, slot);
+    }, Qt::QueuedConnection);
+}
+
+void PluginRelay::sendMessage(QString reply, bool isFin, QString typeMessage, QString id, QList<QString> url, QList<QString> textUrl)
+{
+    relay([=]() { engine->sendReply(reply, isFin, typeMessage, id, url, textUrl); });
+}
+
+void PluginRelay::sendMessageToQml(QString message)
+{
+    relay([=]() { engine->receiveMessageSendedToQml(message); });
+}
+
+void PluginRelay::showQml(QString qml, QString id)
+{
+    relay([=]() { engine->showQml(qml, id); });
+}
+
+void PluginRelay::execAction(QString action)
+{
+    relay([=]() { engine->pluginActionRequested(action); });
+}
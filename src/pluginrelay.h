@@ -0,0 +1,63 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#ifndef PLUGINRELAY_H
+#define PLUGINRELAY_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+
+#include <functional>
+
+class Engine;
+class PluginInterfaceV2;
+
+/**
+ * Receive the signals of a plugin for an engine of the daemon mode. The plugins are shared
+ * by the engines, so a signal goes to the engine which called the plugin last, with the
+ * session of the call, see setCaller.
+ *
+ * The signals are received in the thread which emits them. A signal sent during the call
+ * is given to the engine at once; a signal sent after the request, by a timer or a network
+ * reply of the plugin, is given later in the thread of the engine, see Engine::pluginSignalAfterRequest.
+ * The engine is chosen when the signal is emitted, so a signal of a call is never taken
+ * by the next engine which calls the same plugin.
+ */
+class PluginRelay : public QObject
+{
+    Q_OBJECT
+
+public:
+    PluginRelay(Engine *engine, PluginInterfaceV2 *plug);
+
+    static void setCaller(const PluginInterfaceV2 *plug, const Engine *engine, const QString &session);
+
+private:
+    void relay(const std::function<void()> &slot);
+
+    Engine *engine;
+    PluginInterfaceV2 *plug;
+
+private slots:
+    void sendMessage(QString reply, bool isFin, QString typeMessage, QString id, QList<QString> url, QList<QString> textUrl);
+    void sendMessageToQml(QString message);
+    void showQml(QString qml, QString id);
+    void execAction(QString action);
+};
+
+#endif // PLUGINRELAY_H
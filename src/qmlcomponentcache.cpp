@@ -0,0 +1,80 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "qmlcomponentcache.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QUrl>
+
+QmlComponentCache::~QmlComponentCache()
+{
+    foreach (QList<Entry> entries , plugins) {
+        foreach (Entry entry , entries) delete entry.component;
+    }
+}
+
+/**
+ * Give the compiled interface of a plugin, compile it if the plugin never showed this source
+ *
+ * @param engine the qml engine of the window, owner of the components
+ * @param pluginId the plugin which shows the interface
+ * @param qml the source of the interface
+ * @return the component, nullptr if the source does not compile
+ */
+QQmlComponent *QmlComponentCache::component(QQmlEngine *engine, const QString &pluginId, const QString &qml)
+{
+    QByteArray data = qml.toUtf8();
+    QByteArray hash = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+    QList<Entry> &entries = plugins[pluginId];
+
+    for (int i = 0; i < entries.length(); i++) {
+        if (entries.at(i).hash != hash || entries.at(i).component.isNull()) continue;
+
+        entries.move(i, 0);
+        return entries.first().component;
+    }
+
+    // Same url as the file written by the previous versions, so the relative urls do not change
+    QString fileName = QString(pluginId).replace(".", "_") + ".qml";
+    QUrl url = QUrl::fromLocalFile(QDir::home().filePath(".swifty_cache/" + fileName));
+
+    QQmlComponent *component = new QQmlComponent(engine, engine);
+    component->setData(data, url);
+
+    if (component->isError()) {
+        qCritical("Cannot compile the qml of %s: %s", qPrintable(pluginId), qPrintable(component->errorString()));
+        delete component;
+        return nullptr;
+    }
+
+    QQmlEngine::setObjectOwnership(component, QQmlEngine::CppOwnership);
+    entries.prepend(Entry{hash, component});
+
+    // An evicted component may still be shown by a view of the stack, the view keeps it
+    // and the qml engine deletes it once no view uses it
+    while (entries.length() > MaxPerPlugin) {
+        Entry entry = entries.takeLast();
+        if (entry.component.isNull()) continue;
+
+        entry.component->setParent(nullptr);
+        QQmlEngine::setObjectOwnership(entry.component, QQmlEngine::JavaScriptOwnership);
+    }
+
+    return component;
+}
+
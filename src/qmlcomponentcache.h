@@ -0,0 +1,59 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#ifndef QMLCOMPONENTCACHE_H
+#define QMLCOMPONENTCACHE_H
+
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QByteArray>
+#include <QPointer>
+#include <QQmlEngine>
+#include <QQmlComponent>
+
+/**
+ * The compiled interfaces of the plugins, by plugin and by hash of their qml.
+ *
+ * A plugin gives the source of its interface with the showQml() signal. It is compiled
+ * once, then the QQmlComponent is reused each time the plugin shows the same source.
+ * Nothing is written on disk, the url of a component only resolves the relative urls
+ * of the source. The last MaxPerPlugin sources of each plugin are kept, an older one
+ * is given to the views which show it, see CustomQmlView.
+ */
+class QmlComponentCache
+{
+public:
+    enum { MaxPerPlugin = 4 };
+
+    QmlComponentCache() = default;
+    ~QmlComponentCache();
+
+    QQmlComponent *component(QQmlEngine *engine, const QString &pluginId, const QString &qml);
+
+private:
+    struct Entry
+    {
+        QByteArray hash;
+        QPointer<QQmlComponent> component;
+    };
+
+    // Most recently shown first
+    QHash<QString, QList<Entry>> plugins;
+};
+
+#endif // QMLCOMPONENTCACHE_H
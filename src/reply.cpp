@@ -0,0 +1,133 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "reply.h"
+
+class ReplyData : public QSharedData
+{
+public:
+    Reply::Type type = Reply::Message;
+    QString text;
+    bool isFin = true;
+    QString url;
+    QList<ReplyAction> actions;
+    quint64 requestId = 0;
+};
+
+Reply::Reply() : d(new ReplyData)
+{
+}
+
+Reply::Reply(Type type, const QString &text, bool isFin, quint64 requestId) : d(new ReplyData)
+{
+    d->type = type;
+    d->text = text;
+    d->isFin = isFin;
+    d->requestId = requestId;
+}
+
+Reply::Reply(const Reply &other) = default;
+Reply &Reply::operator=(const Reply &other) = default;
+Reply::~Reply() = default;
+
+/**
+ * Convert the type name used by the plugins to a Reply::Type
+ *
+ * @param typeMessage "message", "settings", "web_without_action_btn" or "web_with_action_btn"
+ * @return the corresponding type, Message if the name is unknown
+ */
+Reply::Type Reply::typeFromString(const QString &typeMessage)
+{
+    if (typeMessage == QLatin1String("settings")) return Settings;
+    if (typeMessage == QLatin1String("web_without_action_btn")) return WebWithoutActionBtn;
+    if (typeMessage == QLatin1String("web_with_action_btn")) return WebWithActionBtn;
+
+    return Message;
+}
+
+Reply::Type Reply::type() const
+{
+    return d->type;
+}
+
+QString Reply::text() const
+{
+    return d->text;
+}
+
+bool Reply::isFin() const
+{
+    return d->isFin;
+}
+
+QString Reply::url() const
+{
+    return d->url;
+}
+
+QList<ReplyAction> Reply::actions() const
+{
+    return d->actions;
+}
+
+QList<QString> Reply::actionLabels() const
+{
+    QList<QString> labels;
+    labels.reserve(d->actions.length());
+
+    for (const ReplyAction &action : d->actions)
+        labels.append(action.first);
+
+    return labels;
+}
+
+QList<QString> Reply::actionCommands() const
+{
+    QList<QString> commands;
+    commands.reserve(d->actions.length());
+
+    for (const ReplyAction &action : d->actions)
+        commands.append(action.second);
+
+    return commands;
+}
+
+quint64 Reply::requestId() const
+{
+    return d->requestId;
+}
+
+void Reply::setUrl(const QString &url)
+{
+    d->url = url;
+}
+
+/**
+ * Add an action button under the message
+ *
+ * @param label the text of the button
+ * @param command the action executed when the button is clicked
+ */
+void Reply::addAction(const QString &label, const QString &command)
+{
+    d->actions.append(ReplyAction(label, command));
+}
+
+void Reply::setRequestId(quint64 requestId)
+{
+    d->requestId = requestId;
+}
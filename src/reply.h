@@ -0,0 +1,88 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#ifndef REPLY_H
+#define REPLY_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QPair>
+#include <QMetaType>
+#include <QSharedDataPointer>
+
+class ReplyData;
+
+/**
+ * (label, command) of an action button displayed under a message
+ */
+typedef QPair<QString, QString> ReplyAction;
+
+/**
+ * A message sent by the engine to the interface.
+ *
+ * The payload is implicitly shared, so passing a Reply through queued
+ * signals only costs a reference count increment.
+ */
+class Reply
+{
+    Q_GADGET
+    Q_PROPERTY(Type type READ type)
+    Q_PROPERTY(QString text READ text)
+    Q_PROPERTY(bool isFin READ isFin)
+    Q_PROPERTY(QString url READ url)
+    Q_PROPERTY(QList<QString> actionLabels READ actionLabels)
+    Q_PROPERTY(QList<QString> actionCommands READ actionCommands)
+    Q_PROPERTY(quint64 requestId READ requestId)
+
+public:
+    enum Type {
+        Message,
+        Settings,
+        WebWithoutActionBtn,
+        WebWithActionBtn
+    };
+    Q_ENUM(Type)
+
+    Reply();
+    Reply(Type type, const QString &text, bool isFin, quint64 requestId = 0);
+    Reply(const Reply &other);
+    Reply &operator=(const Reply &other);
+    ~Reply();
+
+    static Type typeFromString(const QString &typeMessage);
+
+    Type type() const;
+    QString text() const;
+    bool isFin() const;
+    QString url() const;
+    QList<ReplyAction> actions() const;
+    QList<QString> actionLabels() const;
+    QList<QString> actionCommands() const;
+    quint64 requestId() const;
+
+    void setUrl(const QString &url);
+    void addAction(const QString &label, const QString &command);
+    void setRequestId(quint64 requestId);
+
+private:
+    QSharedDataPointer<ReplyData> d;
+};
+
+Q_DECLARE_METATYPE(Reply)
+
+#endif // REPLY_H
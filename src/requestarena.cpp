@@ -0,0 +1,43 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "requestarena.h"
+
+RequestArena::RequestArena() : memory(buffer, sizeof(buffer), std::pmr::new_delete_resource())
+{
+}
+
+/**
+ * @return the memory resource to give to the std::pmr containers of the request
+ */
+std::pmr::memory_resource *RequestArena::resource()
+{
+    return &memory;
+}
+
+RequestArena::Scope::Scope(RequestArena *arena) : arena(arena)
+{
+    arena->depth++;
+}
+
+/**
+ * Release the memory of the request, the next request starts again at the beginning of the buffer
+ */
+RequestArena::Scope::~Scope()
+{
+    if (--arena->depth == 0) arena->memory.release();
+}
@@ -0,0 +1,62 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#ifndef REQUESTARENA_H
+#define REQUESTARENA_H
+
+#include <memory_resource>
+#include <cstddef>
+
+/**
+ * Memory of the temporaries of the matcher for one request.
+ *
+ * The allocations only move a pointer in a buffer and are all released at
+ * once when the outermost Scope ends. The first InitialSize bytes are inside
+ * the arena, so the requests which fit in it do not use the heap at all.
+ */
+class RequestArena
+{
+public:
+    enum { InitialSize = 16 * 1024 };
+
+    /**
+     * The arena is released when the outermost scope ends, so a function
+     * can open a scope whether it is called for a request or alone
+     */
+    class Scope
+    {
+    public:
+        explicit Scope(RequestArena *arena);
+        ~Scope();
+
+    private:
+        RequestArena *arena;
+    };
+
+    RequestArena();
+    RequestArena(const RequestArena &) = delete;
+    RequestArena &operator=(const RequestArena &) = delete;
+
+    std::pmr::memory_resource *resource();
+
+private:
+    alignas(std::max_align_t) char buffer[InitialSize];
+    std::pmr::monotonic_buffer_resource memory;
+    int depth = 0;
+};
+
+#endif // REQUESTARENA_H
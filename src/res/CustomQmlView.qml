@@ -6,13 +6,15 @@ ColumnLayout {
     anchors.margins: 8
     spacing: 10
 
-    property string qmlUrl
+    // Compiled by SwiftyWorker::showQmlSource, kept to show the plugin interface again.
+    // Once the cache has evicted it, this reference keeps it alive while the view exists
+    property Component qmlComponent: null
 
     Loader {
         id: loader
         Layout.fillHeight: true
         Layout.fillWidth: true
-        source: qmlUrl
+        sourceComponent: qmlComponent
     }
 
     RowLayout {
@@ -25,7 +27,7 @@ ColumnLayout {
             borderWidth: 2
             radius: 10
             onClicked: {
-                qmlUrl = ""
+                qmlComponent = null
                 swifty.execAction("app home")
             }
         }
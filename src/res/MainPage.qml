@@ -2,6 +2,8 @@
 import QtQuick.Controls 2.15
 import QtQuick.Layouts 1.15
 
+import SwiftyWorker 1.0
+
 ColumnLayout {
     anchors.fill: parent
     anchors.margins: 10
@@ -10,20 +12,23 @@ ColumnLayout {
     Connections {
         target: swifty
 
-        function onReponse(text, isFin, typeMessage, url, textUrl) {
-            if (isFin)
+        function onReponse(reply) {
+            if (reply.isFin)
                 loading.running = false
-            if (isFin)
+            if (reply.isFin)
                 send.visible = true
 
-            if (typeMessage === "message") {
-                listMessage.model.insert(0, {"isSendUser": false, "text": text})
+            if (reply.type === Reply.Message) {
+                listMessage.model.insert(0, {"isSendUser": false, "text": reply.text})
+
+                var labels = reply.actionLabels
+                var commands = reply.actionCommands
 
                 listAction.model.clear()
                 listAction.visible = false
-                for(var i = 0; i < url.length; i++) {
+                for(var i = 0; i < commands.length; i++) {
                     listAction.visible = true
-                    listAction.model.append({"text": textUrl[i], "action":url[i]})
+                    listAction.model.append({"text": labels[i], "action": commands[i]})
                 }
             }
         }
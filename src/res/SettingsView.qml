@@ -11,7 +11,7 @@ Rectangle {
         id: connect
         target: swifty
 
-        function onReponse(text, isFin, typeMessage, url, textUrl) {
+        function onReponse(reply) {
             txtName.text = settings.value("settings_name", "")
             checkProp.checked = settings.value("settings_proposition", "true") === "true" ? true : false
         }
@@ -19,6 +19,48 @@ Rectangle {
         function onPluginName(name) {
             listPlugin.model.append({"text": name})
         }
+
+        function onStatistics(stats) {
+            txtStats.text = formatStats(stats)
+        }
+    }
+
+    function formatLatency(summary) {
+        return summary.count + qsTr(", médiane ") + summary.p50.toFixed(2) + " ms, p90 " + summary.p90.toFixed(2)
+                + " ms, p99 " + summary.p99.toFixed(2) + " ms"
+    }
+
+    function formatHitRate(cache) {
+        var total = cache.hits + cache.misses
+        return (total === 0 ? 0 : Math.round(100 * cache.hits / total)) + " % (" + cache.hits + "/" + total + ")"
+    }
+
+    function formatStats(stats) {
+        var lines = [
+            qsTr("Requêtes: ") + formatLatency(stats.utterances),
+            qsTr("Règles évaluées par requête: médiane ") + stats.rules.p50 + ", p90 " + stats.rules.p90 + ", max " + stats.rules.max,
+            qsTr("Complétion par frappe: ") + formatLatency(stats.completions),
+            qsTr("Suggestions: ") + formatLatency(stats.suggestions),
+            qsTr("Cache des commandes: ") + formatHitRate(stats.matchCache),
+            qsTr("Cache des règles: ") + formatHitRate(stats.ruleCache)
+        ]
+
+        for (var name in stats.eventLoops)
+            lines.push(qsTr("Latence de la boucle ") + name + ": " + formatLatency(stats.eventLoops[name]))
+
+        for (var id in stats.actions)
+            lines.push(qsTr("Actions de ") + id + ": " + formatLatency(stats.actions[id]))
+
+        return lines.join("\n")
+    }
+
+    // The statistics are refreshed while they are displayed
+    Timer {
+        interval: 1000
+        repeat: true
+        triggeredOnStart: true
+        running: statsPanel.visible
+        onTriggered: swifty.getStatistics()
     }
 
     Component.onCompleted: {
@@ -144,6 +186,15 @@ Rectangle {
                 Layout.fillWidth: true
             }
 
+            MButton {
+                text: statsPanel.visible ? qsTr("Plugins") : qsTr("Statistiques")
+                font.pointSize: 8
+                implicitHeight: 21
+                borderWidth: 2
+                radius: 10
+                onClicked: statsPanel.visible = !statsPanel.visible
+            }
+
             MButton {
                 text: qsTr("Actualiser")
                 font.pointSize: 8
@@ -165,6 +216,7 @@ Rectangle {
             color: "#171717"
             Layout.fillHeight: true
             Layout.fillWidth: true
+            visible: !statsPanel.visible
 
             ListView {
                 id: listPlugin
@@ -202,6 +254,32 @@ Rectangle {
             }
         }
 
+        Rectangle {
+            id: statsPanel
+            border.color: "#aa89a0"
+            border.width: 2
+            radius: 5
+            color: "#171717"
+            Layout.fillHeight: true
+            Layout.fillWidth: true
+            visible: false
+
+            Flickable {
+                clip: true
+                anchors.fill: parent
+                anchors.margins: 5
+                contentHeight: txtStats.implicitHeight
+
+                Text {
+                    id: txtStats
+                    width: parent.width
+                    wrapMode: Text.Wrap
+                    color: "white"
+                    font.pointSize: 10
+                }
+            }
+        }
+
         RowLayout {
             Layout.fillWidth: true
 
@@ -12,12 +12,13 @@ Rectangle {
     property string typeWeb: "web_with_action_btn"
     property string webUrl
 
-    property QtObject defaultProfile: WebEngineProfile {
-        storageName: "Profile"
-        httpUserAgent: "Mozilla/5.0 (Linux; Android 9; SM-A102U) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/74.0.3729.136 Mobile Safari/537.36"
-        offTheRecord: false
-        useForGlobalCertificateVerification: true
-    }
+    // Managed by WebViewPool.qml
+    property bool inUse: false
+    property alias lifecycleState: webEngineView.lifecycleState
+
+    signal released()
+
+    StackView.onRemoved: released()
 
     ColumnLayout {
         anchors.fill: parent
@@ -29,7 +30,6 @@ Rectangle {
             Layout.fillHeight: true
             focus: true
             url: webUrl
-            profile: defaultProfile
 
             settings.autoLoadImages: true
             settings.javascriptEnabled: true
@@ -91,6 +91,12 @@ Rectangle {
                 selection.certificates[0].select();
             }
 
+            // A page which is not shown, covered by another page or kept by the pool, does not run
+            onVisibleChanged: {
+                if (visible) lifecycleState = WebEngineView.LifecycleState.Active
+                else if (lifecycleState === WebEngineView.LifecycleState.Active) lifecycleState = WebEngineView.LifecycleState.Frozen
+            }
+
             onLoadingChanged: function(loadRequest) {
 
             }
@@ -0,0 +1,158 @@
+import QtQuick 2.15
+import QtWebEngine 1.10
+
+// The web views of the web replies. A view which leaves the stack is frozen and kept to be
+// reused by a next reply, the least recently used views above maxViews are destroyed.
+// Above memoryBudget, the hidden views are discarded one by one, the least recently used
+// first: a discarded view keeps its url and loads its page again when it is shown.
+Item {
+    id: pool
+    visible: false
+
+    property int maxViews: 2
+    property real memoryBudget: 0
+
+    // Least recently used first
+    property var views: []
+    property var incubator: null
+    property Component viewComponent: null
+    property real memoryBeforeView: 0
+    property real viewStartedAt: 0
+
+    function component() {
+        if (viewComponent !== null) return viewComponent
+
+        // One profile, so one network and disk cache, is shared by all the views
+        var profile = WebEngine.defaultProfile
+        profile.storageName = "Profile"
+        profile.httpUserAgent = "Mozilla/5.0 (Linux; Android 9; SM-A102U) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/74.0.3729.136 Mobile Safari/537.36"
+        profile.offTheRecord = false
+        profile.useForGlobalCertificateVerification = true
+
+        viewComponent = Qt.createComponent("WebEngineView.qml")
+        if (viewComponent.status === Component.Error) console.warn(viewComponent.errorString())
+
+        return viewComponent
+    }
+
+    function isPoolView(item) {
+        return item !== null && views.indexOf(item) >= 0
+    }
+
+    function addView(view) {
+        view.released.connect(function() { release(view) })
+        views = views.concat([view])
+
+        var memory = swifty.residentMemory() - memoryBeforeView
+        console.info("Web view created (" + views.length + "/" + maxViews + ") in " + (Date.now() - viewStartedAt) + " ms, resident memory +" + Math.round(memory / 1048576) + " MiB")
+        swifty.webViewCreated(Date.now() - viewStartedAt, memory)
+    }
+
+    function moveToEnd(view) {
+        var list = views.filter(function(item) { return item !== view })
+        list.push(view)
+        views = list
+    }
+
+    /**
+     * Create a view in the background if none can be reused, so the first web reply does not wait for the web engine
+     */
+    function prewarm() {
+        if (incubator !== null || views.length >= maxViews) return
+        for (var i = 0; i < views.length; i++) {
+            if (!views[i].inUse) return
+        }
+
+        memoryBeforeView = swifty.residentMemory()
+        viewStartedAt = Date.now()
+        incubator = component().incubateObject(pool, {"visible": false})
+        if (incubator === null) return
+
+        if (incubator.status !== Component.Loading) incubated(incubator.status)
+        else incubator.onStatusChanged = incubated
+    }
+
+    function incubated(status) {
+        if (status === Component.Ready) addView(incubator.object)
+        incubator = null
+    }
+
+    /**
+     * @param url the page to show
+     * @return an idle view which already shows the page, else the least recently used idle view, else a new view
+     */
+    function acquire(url) {
+        if (incubator !== null) incubator.forceCompletion()
+
+        var view = null
+        for (var i = 0; i < views.length && view === null; i++) {
+            if (!views[i].inUse && views[i].webUrl === url) view = views[i]
+        }
+        for (i = 0; i < views.length && view === null; i++) {
+            if (!views[i].inUse) view = views[i]
+        }
+
+        // All the kept views are in the stack: the new one is above maxViews until trim() destroys an idle view
+        if (view === null) {
+            memoryBeforeView = swifty.residentMemory()
+            viewStartedAt = Date.now()
+            view = component().createObject(pool, {"visible": false})
+            if (view === null) return null
+
+            addView(view)
+        }
+
+        view.inUse = true
+        view.lifecycleState = WebEngineView.LifecycleState.Active
+        moveToEnd(view)
+
+        return view
+    }
+
+    function release(view) {
+        view.inUse = false
+        moveToEnd(view)
+        trim()
+        checkMemory()
+    }
+
+    function trim() {
+        var excess = views.length - maxViews
+        var kept = []
+
+        for (var i = 0; i < views.length; i++) {
+            if (excess > 0 && !views[i].inUse) {
+                views[i].destroy()
+                excess--
+            }
+            else kept.push(views[i])
+        }
+
+        views = kept
+    }
+
+    function checkMemory() {
+        if (memoryBudget <= 0) return
+
+        var memory = swifty.webMemory()
+        if (memory < 0 || memory <= memoryBudget) return
+
+        // The render process of a view is freed asynchronously, so one view is discarded by check
+        for (var i = 0; i < views.length; i++) {
+            if (!views[i].visible && views[i].lifecycleState !== WebEngineView.LifecycleState.Discarded) {
+                views[i].lifecycleState = WebEngineView.LifecycleState.Discarded
+                console.info("Web view discarded, memory " + Math.round(memory / 1048576) + " MiB above the budget of " + Math.round(memoryBudget / 1048576) + " MiB")
+                return
+            }
+        }
+    }
+
+    Timer {
+        interval: 5000
+        repeat: true
+        running: memoryBudget > 0 && views.length > 0
+        onTriggered: {
+            checkMemory()
+        }
+    }
+}
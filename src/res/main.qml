@@ -26,13 +26,28 @@ Window {
         swifty.setWindowVisibility(false)
     }
 
-    property QtObject webView: WebEngineView {}
     property QtObject settingsView: SettingsView {}
     property QtObject customView: CustomQmlView {}
 
     property string type
     property string site
 
+    function loadWebView() {
+        webViews.prewarm()
+    }
+
+    function showWebView() {
+        // A web reply shown over another one navigates its view instead of stacking a new one
+        if (webViews.isPoolView(stack.currentItem)) {
+            stack.currentItem.typeWeb = type
+            stack.currentItem.webUrl = site
+            return
+        }
+
+        var view = webViews.acquire(site)
+        if (view !== null) stack.push(view, {"typeWeb": type, "webUrl": site})
+    }
+
     Rectangle {
         x: swifty.getOs() !== "windows" ? 10 : 0
         y: swifty.getOs() !== "windows" ? 10 : 0
@@ -51,7 +66,25 @@ Window {
             repeat: false
             running: false
             onTriggered: {
-                stack.push(webView, {"typeWeb": type, "webUrl": site})
+                showWebView()
+            }
+        }
+
+        // The web engine (Chromium, the web profile and the render process) is not started
+        // with the window but by the first web reply, or after --web-prewarm once the window is shown
+        WebViewPool {
+            id: webViews
+            maxViews: swifty.getWebViews()
+            memoryBudget: swifty.getWebMemoryBudget() * 1048576
+        }
+
+        Timer {
+            id: timerWebPrewarm
+            interval: Math.max(1, swifty.getWebPrewarm())
+            repeat: false
+            running: window.visible && swifty.getWebPrewarm() > 0 && webViews.views.length === 0
+            onTriggered: {
+                loadWebView()
             }
         }
 
@@ -68,15 +101,23 @@ Window {
         Connections {
             target: swifty
 
-            function onReponse(text, isFin, typeMessage, url, textUrl) {
-                if (typeMessage === "web_without_action_btn" || typeMessage === "web_with_action_btn") {
-                    type = typeMessage
-                    site = url[0]
+            function onReponse(reply) {
+                if (reply.type === Reply.WebWithoutActionBtn) {
+                    type = "web_without_action_btn"
+                    site = reply.url
+                    loadWebView()
+                    timerWeb.running = true
+                }
+
+                else if (reply.type === Reply.WebWithActionBtn) {
+                    type = "web_with_action_btn"
+                    site = reply.url
+                    loadWebView()
                     timerWeb.running = true
                 }
 
-                else if (typeMessage === "settings") {
-                    type = typeMessage
+                else if (reply.type === Reply.Settings) {
+                    type = "settings"
                     timerSettings.running = true
                 }
             }
@@ -104,8 +145,8 @@ Window {
                 swifty.setWindowVisibility(false)
             }
 
-            function onShowQml(fileUrl) {
-                stack.push(customView, {"qmlUrl": fileUrl})
+            function onShowQml(component) {
+                stack.push(customView, {"qmlComponent": component})
             }
 
             function onHomeScreen() {
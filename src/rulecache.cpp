@@ -0,0 +1,199 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "rulecache.h"
+
+#include <QDir>
+#include <QBuffer>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QCryptographicHash>
+
+RuleCache::RuleCache()
+{
+    QDir dir(QDir::homePath());
+    if (!dir.exists(".swifty_cache")) dir.mkdir(".swifty_cache");
+    dir.cd(".swifty_cache");
+
+    file.setFileName(dir.filePath("rules.cache"));
+}
+
+RuleCache::~RuleCache()
+{
+    close();
+}
+
+/**
+ * Compute the key of a plugin in the cache
+ *
+ * @param xml the xml returned by getDataXml()
+ * @param library the .sw file of the plugin
+ * @return a hash which changes when the xml or the library change
+ */
+QByteArray RuleCache::key(const QString &xml, const QFileInfo &library)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(xml.toUtf8());
+    hash.addData(library.absoluteFilePath().toUtf8());
+    hash.addData(QByteArray::number(library.size()));
+    hash.addData(QByteArray::number(library.lastModified().toMSecsSinceEpoch()));
+    hash.addData(QByteArray::number(int(Version)));
+
+    return hash.result();
+}
+
+/**
+ * Map the cache file in memory and read its index
+ *
+ * @return if the file exists and has the current version
+ */
+bool RuleCache::load()
+{
+    close();
+
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    size = file.size();
+    data = file.map(0, size);
+
+    if (data == nullptr) {
+        close();
+        return false;
+    }
+
+    QByteArray header = QByteArray::fromRawData(reinterpret_cast<const char *>(data), int(size));
+    QBuffer buffer(&header);
+    buffer.open(QIODevice::ReadOnly);
+
+    QDataStream stream(&buffer);
+    stream.setVersion(QDataStream::Qt_5_15);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint32 entryCount = 0;
+    stream >> magic >> version >> entryCount;
+
+    if (magic != Magic || version != Version) {
+        close();
+        return false;
+    }
+
+    for (int i = 0; i < entryCount && stream.status() == QDataStream::Ok; i++) {
+        QByteArray entryKey;
+        qint64 offset = 0;
+        qint64 length = 0;
+        stream >> entryKey >> offset >> length;
+        entries.insert(entryKey, qMakePair(offset, length));
+    }
+
+    dataOffset = buffer.pos();
+
+    if (stream.status() != QDataStream::Ok) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Read the compiled rules of a plugin from the mapped file
+ *
+ * @param key the key returned by RuleCache::key()
+ * @param ruleSet the rules read
+ * @return if the plugin is in the cache
+ */
+bool RuleCache::find(const QByteArray &key, RuleSet *ruleSet) const
+{
+    if (data == nullptr || !entries.contains(key)) return false;
+
+    QPair<qint64, qint64> entry = entries.value(key);
+    qint64 offset = dataOffset + entry.first;
+
+    if (entry.first < 0 || entry.second < 0 || offset + entry.second > size) return false;
+
+    QByteArray bytes = QByteArray::fromRawData(reinterpret_cast<const char *>(data + offset), int(entry.second));
+    QDataStream stream(bytes);
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream >> *ruleSet;
+
+    return stream.status() == QDataStream::Ok && ruleSet->key == key;
+}
+
+/**
+ * Replace the cache file with the rules of the plugins actually loaded
+ *
+ * @param ruleSets the compiled rules
+ * @return if the file has been written
+ */
+bool RuleCache::save(const QList<RuleSet> &ruleSets)
+{
+    close();
+
+    QList<QByteArray> blobs;
+    for (const RuleSet &ruleSet : ruleSets) {
+        QByteArray blob;
+        QDataStream stream(&blob, QIODevice::WriteOnly);
+        stream.setVersion(QDataStream::Qt_5_15);
+        stream << ruleSet;
+        blobs.append(blob);
+    }
+
+    QSaveFile saveFile(file.fileName());
+    if (!saveFile.open(QIODevice::WriteOnly)) {
+        qDebug("Error write rules cache");
+        return false;
+    }
+
+    QDataStream stream(&saveFile);
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream << quint32(Magic) << quint32(Version) << qint32(ruleSets.length());
+
+    qint64 offset = 0;
+    for (int i = 0; i < ruleSets.length(); i++) {
+        stream << ruleSets.at(i).key << offset << qint64(blobs.at(i).length());
+        offset += blobs.at(i).length();
+    }
+
+    for (const QByteArray &blob : blobs)
+        stream.writeRawData(blob.constData(), blob.length());
+
+    return saveFile.commit();
+}
+
+/**
+ * @return the number of plugins in the loaded file
+ */
+int RuleCache::count() const
+{
+    return entries.count();
+}
+
+void RuleCache::close()
+{
+    if (data != nullptr) {
+        file.unmap(const_cast<uchar *>(data));
+        data = nullptr;
+    }
+
+    if (file.isOpen()) file.close();
+
+    entries.clear();
+    dataOffset = 0;
+    size = 0;
+}
@@ -0,0 +1,61 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#ifndef RULECACHE_H
+#define RULECACHE_H
+
+#include <QFile>
+#include <QHash>
+#include <QPair>
+#include <QString>
+#include <QByteArray>
+#include <QFileInfo>
+
+#include "ruleset.h"
+
+/**
+ * Binary file ~/.swifty_cache/rules.cache containing the compiled rules of the plugins.
+ *
+ * Each RuleSet is stored under a key computed from the xml and the library
+ * of the plugin, so an unchanged plugin is read back without parsing its xml.
+ */
+class RuleCache
+{
+public:
+    enum { Magic = 0x53575243, Version = 4 };
+
+    RuleCache();
+    ~RuleCache();
+
+    static QByteArray key(const QString &xml, const QFileInfo &library);
+
+    bool load();
+    bool find(const QByteArray &key, RuleSet *ruleSet) const;
+    bool save(const QList<RuleSet> &ruleSets);
+    int count() const;
+
+private:
+    void close();
+
+    QFile file;
+    const uchar *data = nullptr;
+    qint64 dataOffset = 0;
+    qint64 size = 0;
+    QHash<QByteArray, QPair<qint64, qint64>> entries;
+};
+
+#endif // RULECACHE_H
@@ -0,0 +1,586 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "ruleset.h"
+#include "slotparser.h"
+
+#include <QDomDocument>
+#include <QStringList>
+
+#include <climits>
+#include <algorithm>
+
+//===================================================
+//==================== RuleItem =====================
+//===================================================
+
+/**
+ * Check if one of the words is in the command
+ *
+ * @param tokenIds the words of the command converted by RuleSet::tokenIds
+ * @param words the words to search
+ */
+static bool containsOneOf(const TokenIds &tokenIds, const QVector<int> &words)
+{
+    for (int word : words) {
+        if (std::find(tokenIds.begin(), tokenIds.end(), word) != tokenIds.end()) return true;
+    }
+
+    return false;
+}
+
+/**
+ * Check the <Keywords> of the item, the last one which accepts the length of the command decides
+ *
+ * The <NoWords> are checked against the words as typed: the spell corrector could turn
+ * a word close to a forbidden word into it and refuse the item.
+ *
+ * @param tokenIds the corrected words of the command converted by RuleSet::tokenIds
+ * @param typedIds the words of the command before the correction
+ * @return if the item corresponds to the command
+ */
+bool RuleItem::matchKeywords(const TokenIds &tokenIds, const TokenIds &typedIds) const
+{
+    const int length = int(tokenIds.size());
+    bool isOk = false;
+
+    for (const RuleKeywords &keyword : keywords) {
+        if (length < keyword.minWord || length > keyword.maxWord) continue;
+
+        isOk = true;
+
+        for (const QVector<int> &words : keyword.words) {
+            if (!containsOneOf(tokenIds, words)) {
+                isOk = false;
+                break;
+            }
+        }
+
+        for (int i = 0; i < keyword.noWords.length() && isOk; i++) {
+            if (containsOneOf(typedIds, keyword.noWords.at(i))) isOk = false;
+        }
+    }
+
+    return isOk;
+}
+
+/**
+ * Read the <Var> and <Slot> elements of the item.
+ *
+ * The command is read once: the slot table gives the elements which use each word as a
+ * keyword or as an enum value. Then the words following the keyword of each element are
+ * taken, or parsed by SlotParser for the number, duration and date elements.
+ *
+ * @param cmd the words list of the command
+ * @param tokenIds the same words converted by RuleSet::tokenIds, the temporaries use its memory resource
+ * @param mode use the keyword found the furthest in the command or the first keyword found
+ * @return the words of each element in the order of the elements, empty if the element is not filled
+ */
+QList<QString> RuleItem::extractVars(const QList<QString> &cmd, const TokenIds &tokenIds, VarMode mode) const
+{
+    const int count = vars.length();
+    std::pmr::memory_resource *resource = tokenIds.get_allocator().resource();
+    std::pmr::vector<int> anchor(count, -1, resource);
+    std::pmr::vector<int> anchorRank(count, INT_MAX, resource);
+    std::pmr::vector<int> value(count, -1, resource);
+
+    for (int i = 0; i < int(tokenIds.size()); i++) {
+        auto edges = slotTable.constFind(tokenIds.at(i));
+        if (edges == slotTable.constEnd()) continue;
+
+        for (const RuleSlotEdge &edge : edges.value()) {
+            if (edge.isValue) {
+                if (value[edge.var] == -1) value[edge.var] = i;
+            }
+            else if (mode == LastKeyword || edge.rank <= anchorRank[edge.var]) {
+                anchor[edge.var] = i;
+                anchorRank[edge.var] = edge.rank;
+            }
+        }
+    }
+
+    QList<QString> result;
+
+    for (int v = 0; v < count; v++) {
+        const RuleVar &ruleVar = vars.at(v);
+        int from = -1;
+        int length = 0;
+
+        if (ruleVar.type == RuleVar::Enum) {
+            from = value[v];
+            length = 1;
+        }
+        else if (ruleVar.type == RuleVar::Text) {
+            if (anchor[v] != -1) {
+                from = anchor[v]+1;
+                length = ruleVar.max > 0 ? qMin(ruleVar.max, cmd.length()-from) : cmd.length()-from;
+            }
+        }
+        else if (ruleVar.keywords.isEmpty() || anchor[v] != -1) {
+            int start = anchor[v]+1;
+            int end = ruleVar.max > 0 ? qMin(cmd.length(), start+ruleVar.max) : cmd.length();
+
+            for (int i = start; i < end && from == -1; i++) {
+                length = SlotParser::read(ruleVar.type, cmd, i);
+                if (length > 0) from = i;
+            }
+        }
+
+        result.append(from != -1 && length > 0 ? cmd.mid(from, length).join(" ") : QString());
+    }
+
+    return result;
+}
+
+/**
+ * Build the word => <Var> elements table used by extractVars
+ */
+void RuleItem::buildSlotTable()
+{
+    slotTable.clear();
+
+    for (int v = 0; v < vars.length(); v++) {
+        const RuleVar &ruleVar = vars.at(v);
+
+        for (int rank = 0; rank < ruleVar.keywords.length(); rank++) {
+            QVector<RuleSlotEdge> &edges = slotTable[ruleVar.keywords.at(rank)];
+            bool isKnown = false;
+
+            // A keyword written twice keeps its first rank
+            for (const RuleSlotEdge &edge : edges) {
+                if (edge.var == v && !edge.isValue) isKnown = true;
+            }
+
+            if (!isKnown) {
+                RuleSlotEdge edge;
+                edge.var = v;
+                edge.rank = rank;
+                edges.append(edge);
+            }
+        }
+
+        for (int word : ruleVar.values) {
+            RuleSlotEdge edge;
+            edge.var = v;
+            edge.isValue = true;
+            slotTable[word].append(edge);
+        }
+    }
+}
+
+//===================================================
+//===================== RuleVar =====================
+//===================================================
+
+/**
+ * Convert the type attribute of a <Slot> to a RuleVar::Type
+ *
+ * @param type "number", "duration", "datetime", "enum" or "text"
+ * @return the corresponding type, Text if the name is unknown
+ */
+RuleVar::Type RuleVar::typeFromString(const QString &type)
+{
+    if (type == QLatin1String("number")) return Number;
+    if (type == QLatin1String("duration")) return Duration;
+    if (type == QLatin1String("datetime")) return DateTime;
+    if (type == QLatin1String("enum")) return Enum;
+
+    return Text;
+}
+
+//===================================================
+//===================== RuleSet =====================
+//===================================================
+
+/**
+ * Compile the xml of a plugin
+ *
+ * @param pluginId the plugin id
+ * @param xml the xml returned by getDataXml()
+ * @param commands the propositions returned by getCommande()
+ * @param key the key of the plugin in the rule cache
+ * @return the compiled rules
+ */
+RuleSet RuleSet::compile(const QString &pluginId, const QString &xml, const QList<QString> &commands, const QByteArray &key)
+{
+    RuleSet ruleSet;
+    ruleSet.pluginId = pluginId;
+    ruleSet.key = key;
+    ruleSet.commands = commands;
+
+    QDomDocument doc;
+    doc.setContent(xml, false);
+
+    QDomElement item = doc.documentElement().firstChildElement();
+
+    while (!item.isNull()) {
+        ruleSet.items.append(ruleSet.compileItem(item));
+        item = item.nextSiblingElement();
+    }
+
+    return ruleSet;
+}
+
+/**
+ * Return the index of a word in the vocabulary
+ *
+ * @param word the word
+ * @return the index or -1 if no rule uses this word
+ */
+int RuleSet::wordId(const QString &word) const
+{
+    return index.value(word, -1);
+}
+
+/**
+ * Convert the words of a command to indexes of the vocabulary
+ *
+ * @param cmd the words list of the command
+ * @param resource the memory of the indexes, the arena of the request in the engine
+ * @return an index for each word, -1 for the unknown words
+ */
+TokenIds RuleSet::tokenIds(const QList<QString> &cmd, std::pmr::memory_resource *resource) const
+{
+    TokenIds ids(resource);
+    ids.reserve(cmd.length());
+
+    for (const QString &word : cmd)
+        ids.push_back(wordId(word));
+
+    return ids;
+}
+
+/**
+ * Rebuild the word => index table after the vocabulary is read from the cache
+ */
+void RuleSet::buildIndex()
+{
+    index.clear();
+    index.reserve(vocabulary.length());
+
+    for (int i = 0; i < vocabulary.length(); i++)
+        index.insert(vocabulary.at(i), i);
+}
+
+RuleItem RuleSet::compileItem(const QDomElement &element)
+{
+    RuleItem item;
+    item.id = element.attribute("id", "");
+    item.needId = element.attribute("needId", "");
+
+    QDomElement props = element.firstChildElement();
+
+    while (!props.isNull()) {
+        if (props.tagName() == "Keywords") {
+            RuleKeywords keyword;
+            keyword.minWord = props.attribute("minWord").toInt();
+            keyword.maxWord = props.attribute("maxWord").toInt();
+
+            QDomElement words = props.firstChildElement();
+
+            while (!words.isNull()) {
+                if (words.tagName() == "Words") keyword.words.append(compileWords(words));
+                else if (words.tagName() == "NoWords") keyword.noWords.append(compileWords(words));
+
+                words = words.nextSiblingElement();
+            }
+
+            item.keywords.append(keyword);
+        }
+
+        else if (props.tagName() == "Var") {
+            RuleVar ruleVar;
+            ruleVar.max = props.attribute("max").toInt();
+            ruleVar.keywords = compileWords(props);
+            item.steps.append(RuleStep{RuleStep::Var, item.vars.length()});
+            item.vars.append(ruleVar);
+        }
+
+        else if (props.tagName() == "Slot") {
+            RuleVar ruleVar;
+            ruleVar.name = props.attribute("name");
+            ruleVar.type = RuleVar::typeFromString(props.attribute("type"));
+            ruleVar.max = props.attribute("max").toInt();
+
+            QDomElement word = props.firstChildElement();
+
+            while (!word.isNull()) {
+                if (word.tagName() == "value") ruleVar.values.append(intern(word.text()));
+                else ruleVar.keywords.append(intern(word.text()));
+
+                word = word.nextSiblingElement();
+            }
+
+            item.steps.append(RuleStep{RuleStep::Var, item.vars.length()});
+            item.vars.append(ruleVar);
+        }
+
+        else if (props.tagName() == "Reply") {
+            item.steps.append(RuleStep{RuleStep::Reply, item.replies.length()});
+            item.replies.append(compileBlock(props, "rep"));
+        }
+
+        else if (props.tagName() == "Actions") {
+            item.steps.append(RuleStep{RuleStep::Actions, item.actions.length()});
+            item.actions.append(compileBlock(props, "action"));
+        }
+
+        else if (props.tagName() == "Prop") {
+            QList<QString> listProp;
+            QDomElement mProp = props.firstChildElement();
+
+            while (!mProp.isNull()) {
+                listProp.append(mProp.text());
+                mProp = mProp.nextSiblingElement();
+            }
+
+            item.steps.append(RuleStep{RuleStep::Prop, item.props.length()});
+            item.props.append(listProp);
+        }
+
+        else if (props.tagName() == "Examples") {
+            QDomElement example = props.firstChildElement();
+
+            while (!example.isNull()) {
+                item.examples.append(example.text());
+                example = example.nextSiblingElement();
+            }
+        }
+
+        else if (props.tagName() == "Item") {
+            item.children.append(compileItem(props));
+        }
+
+        props = props.nextSiblingElement();
+    }
+
+    item.buildSlotTable();
+
+    return item;
+}
+
+/**
+ * Compile a <Reply> or an <Actions> element
+ *
+ * @param element the element
+ * @param entryTag "rep" or "action"
+ */
+RuleBlock RuleSet::compileBlock(const QDomElement &element, const QString &entryTag)
+{
+    RuleBlock block;
+    QDomElement child = element.firstChildElement();
+
+    while (!child.isNull()) {
+        if (child.tagName() == entryTag) {
+            RuleBranch branch;
+
+            // A <rep> takes all the following elements as possible replies
+            if (entryTag == "rep") {
+                while (!child.isNull()) {
+                    branch.entries.append(child.text());
+                    child = child.nextSiblingElement();
+                }
+
+                block.append(branch);
+                break;
+            }
+
+            branch.entries.append(child.text());
+            block.append(branch);
+        }
+
+        else if (child.tagName() == "condition" && child.attribute("if") != "") {
+            RuleBranch branch;
+            branch.kind = RuleBranch::If;
+
+            const QString condition = child.attribute("if");
+            bool isConditionA = true;
+
+            for (int i = 0; i < condition.length(); i++) {
+                if (condition.at(i) == '!') { branch.condition.op = RuleCondition::NotEqual; isConditionA = false; }
+                else if (condition.at(i) == '=') { branch.condition.op = RuleCondition::Equal; isConditionA = false; }
+                else {
+                    if (isConditionA) branch.condition.left.append(condition.at(i));
+                    else branch.condition.right.append(condition.at(i));
+                }
+            }
+
+            QDomElement entry = child.firstChildElement();
+
+            while (!entry.isNull()) {
+                branch.entries.append(entry.text());
+                entry = entry.nextSiblingElement();
+            }
+
+            block.append(branch);
+        }
+
+        else if (child.tagName() == "else") {
+            RuleBranch branch;
+            branch.kind = RuleBranch::Else;
+
+            QDomElement entry = child.firstChildElement();
+
+            while (!entry.isNull()) {
+                branch.entries.append(entry.text());
+                entry = entry.nextSiblingElement();
+            }
+
+            block.append(branch);
+        }
+
+        child = child.nextSiblingElement();
+    }
+
+    return block;
+}
+
+/**
+ * Intern the text of the children of an element
+ */
+QVector<int> RuleSet::compileWords(const QDomElement &element)
+{
+    QVector<int> words;
+    QDomElement word = element.firstChildElement();
+
+    while (!word.isNull()) {
+        words.append(intern(word.text()));
+        word = word.nextSiblingElement();
+    }
+
+    return words;
+}
+
+int RuleSet::intern(const QString &word)
+{
+    int id = index.value(word, -1);
+
+    if (id == -1) {
+        id = vocabulary.length();
+        vocabulary.append(word);
+        index.insert(word, id);
+    }
+
+    return id;
+}
+
+//===================================================
+//================== Serialization ==================
+//===================================================
+
+QDataStream &operator<<(QDataStream &out, const RuleCondition &condition)
+{
+    return out << qint32(condition.op) << condition.left << condition.right;
+}
+
+QDataStream &operator>>(QDataStream &in, RuleCondition &condition)
+{
+    qint32 op;
+    in >> op >> condition.left >> condition.right;
+    condition.op = RuleCondition::Operator(op);
+    return in;
+}
+
+QDataStream &operator<<(QDataStream &out, const RuleBranch &branch)
+{
+    return out << qint32(branch.kind) << branch.condition << branch.entries;
+}
+
+QDataStream &operator>>(QDataStream &in, RuleBranch &branch)
+{
+    qint32 kind;
+    in >> kind >> branch.condition >> branch.entries;
+    branch.kind = RuleBranch::Kind(kind);
+    return in;
+}
+
+QDataStream &operator<<(QDataStream &out, const RuleKeywords &keywords)
+{
+    return out << qint32(keywords.minWord) << qint32(keywords.maxWord) << keywords.words << keywords.noWords;
+}
+
+QDataStream &operator>>(QDataStream &in, RuleKeywords &keywords)
+{
+    qint32 minWord, maxWord;
+    in >> minWord >> maxWord >> keywords.words >> keywords.noWords;
+    keywords.minWord = minWord;
+    keywords.maxWord = maxWord;
+    return in;
+}
+
+QDataStream &operator<<(QDataStream &out, const RuleVar &ruleVar)
+{
+    return out << ruleVar.name << qint32(ruleVar.type) << qint32(ruleVar.max) << ruleVar.keywords << ruleVar.values;
+}
+
+QDataStream &operator>>(QDataStream &in, RuleVar &ruleVar)
+{
+    qint32 type, max;
+    in >> ruleVar.name >> type >> max >> ruleVar.keywords >> ruleVar.values;
+    ruleVar.type = RuleVar::Type(type);
+    ruleVar.max = max;
+    return in;
+}
+
+QDataStream &operator<<(QDataStream &out, const RuleStep &step)
+{
+    return out << qint32(step.kind) << qint32(step.index);
+}
+
+QDataStream &operator>>(QDataStream &in, RuleStep &step)
+{
+    qint32 kind, index;
+    in >> kind >> index;
+    step.kind = RuleStep::Kind(kind);
+    step.index = index;
+    return in;
+}
+
+QDataStream &operator<<(QDataStream &out, const RuleItem &item)
+{
+    return out << item.id << item.needId << item.keywords << item.vars << item.replies << item.actions << item.props << item.steps << item.examples << item.children;
+}
+
+QDataStream &operator>>(QDataStream &in, RuleItem &item)
+{
+    in >> item.id >> item.needId >> item.keywords >> item.vars >> item.replies >> item.actions >> item.props >> item.steps >> item.examples >> item.children;
+
+    // The engine reads the elements by their step without checking them, a damaged cache is compiled again
+    foreach (RuleStep step , item.steps) {
+        int count = step.kind == RuleStep::Var ? item.vars.length()
+                  : step.kind == RuleStep::Reply ? item.replies.length()
+                  : step.kind == RuleStep::Actions ? item.actions.length()
+                  : step.kind == RuleStep::Prop ? item.props.length() : 0;
+
+        if (step.index < 0 || step.index >= count) in.setStatus(QDataStream::ReadCorruptData);
+    }
+
+    item.buildSlotTable();
+    return in;
+}
+
+QDataStream &operator<<(QDataStream &out, const RuleSet &ruleSet)
+{
+    return out << ruleSet.pluginId << ruleSet.key << ruleSet.vocabulary << ruleSet.commands << ruleSet.items;
+}
+
+QDataStream &operator>>(QDataStream &in, RuleSet &ruleSet)
+{
+    in >> ruleSet.pluginId >> ruleSet.key >> ruleSet.vocabulary >> ruleSet.commands >> ruleSet.items;
+    ruleSet.buildIndex();
+    return in;
+}
@@ -0,0 +1,183 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#ifndef RULESET_H
+#define RULESET_H
+
+#include <QString>
+#include <QList>
+#include <QVector>
+#include <QHash>
+#include <QByteArray>
+#include <QDataStream>
+#include <QDomElement>
+
+#include <memory_resource>
+#include <vector>
+
+/**
+ * The words of a command converted to indexes of the vocabulary of a RuleSet,
+ * allocated in the RequestArena of the engine while a request is analized
+ */
+typedef std::pmr::vector<int> TokenIds;
+
+/**
+ * The if="a=b" or if="a!b" attribute of a <condition>
+ */
+struct RuleCondition
+{
+    enum Operator { None, Equal, NotEqual };
+
+    Operator op = None;
+    QString left;
+    QString right;
+};
+
+/**
+ * A <rep>/<action> list, a <condition> or an <else> of a <Reply> or <Actions> element
+ */
+struct RuleBranch
+{
+    enum Kind { Always, If, Else };
+
+    Kind kind = Always;
+    RuleCondition condition;
+    QList<QString> entries;
+};
+
+/**
+ * The content of one <Reply> or <Actions> element
+ */
+typedef QList<RuleBranch> RuleBlock;
+
+/**
+ * A <Keywords> element, words are indexes in the vocabulary of the RuleSet
+ */
+struct RuleKeywords
+{
+    int minWord = 0;
+    int maxWord = 0;
+    QList<QVector<int>> words;
+    QList<QVector<int>> noWords;
+};
+
+/**
+ * A <Var> element or a typed <Slot> element
+ */
+struct RuleVar
+{
+    enum Type { Text, Number, Duration, DateTime, Enum };
+
+    QString name;
+    Type type = Text;
+    int max = 0;
+    QVector<int> keywords;
+    QVector<int> values;
+
+    static Type typeFromString(const QString &type);
+};
+
+/**
+ * An entry of the slot table of an item: the word is a keyword or a value of a <Var>
+ */
+struct RuleSlotEdge
+{
+    int var = 0;
+    int rank = 0;
+    bool isValue = false;
+};
+
+/**
+ * A <Var>, <Slot>, <Reply>, <Actions> or <Prop> element of an item, they are executed in the order of the xml
+ */
+struct RuleStep
+{
+    enum Kind { Var, Reply, Actions, Prop };
+
+    Kind kind = Reply;
+    int index = 0; // the position in the vars, replies, actions or props of the item
+};
+
+/**
+ * An <Item> of a plugin and its sub-items used to continue the conversation
+ */
+struct RuleItem
+{
+    enum VarMode { LastKeyword, FirstKeyword };
+
+    QString id;
+    QString needId;
+    QList<RuleKeywords> keywords;
+    QList<RuleVar> vars;
+    QList<RuleBlock> replies;
+    QList<RuleBlock> actions;
+    QList<QList<QString>> props;
+    QList<RuleStep> steps;
+    QList<QString> examples;
+    QList<RuleItem> children;
+
+    bool matchKeywords(const TokenIds &tokenIds, const TokenIds &typedIds) const;
+    QList<QString> extractVars(const QList<QString> &cmd, const TokenIds &tokenIds, VarMode mode) const;
+    void buildSlotTable();
+
+private:
+    QHash<int, QVector<RuleSlotEdge>> slotTable;
+};
+
+/**
+ * The rules of a plugin compiled from the xml returned by getDataXml()
+ */
+class RuleSet
+{
+public:
+    static RuleSet compile(const QString &pluginId, const QString &xml, const QList<QString> &commands, const QByteArray &key);
+
+    int wordId(const QString &word) const;
+    TokenIds tokenIds(const QList<QString> &cmd, std::pmr::memory_resource *resource = std::pmr::get_default_resource()) const;
+    void buildIndex();
+
+    QString pluginId;
+    QByteArray key;
+    QList<QString> vocabulary;
+    QList<QString> commands;
+    QList<RuleItem> items;
+
+private:
+    RuleItem compileItem(const QDomElement &element);
+    RuleBlock compileBlock(const QDomElement &element, const QString &entryTag);
+    QVector<int> compileWords(const QDomElement &element);
+    int intern(const QString &word);
+
+    QHash<QString, int> index;
+};
+
+QDataStream &operator<<(QDataStream &out, const RuleCondition &condition);
+QDataStream &operator>>(QDataStream &in, RuleCondition &condition);
+QDataStream &operator<<(QDataStream &out, const RuleBranch &branch);
+QDataStream &operator>>(QDataStream &in, RuleBranch &branch);
+QDataStream &operator<<(QDataStream &out, const RuleKeywords &keywords);
+QDataStream &operator>>(QDataStream &in, RuleKeywords &keywords);
+QDataStream &operator<<(QDataStream &out, const RuleVar &ruleVar);
+QDataStream &operator>>(QDataStream &in, RuleVar &ruleVar);
+QDataStream &operator<<(QDataStream &out, const RuleStep &step);
+QDataStream &operator>>(QDataStream &in, RuleStep &step);
+QDataStream &operator<<(QDataStream &out, const RuleItem &item);
+QDataStream &operator>>(QDataStream &in, RuleItem &item);
+QDataStream &operator<<(QDataStream &out, const RuleSet &ruleSet);
+QDataStream &operator>>(QDataStream &in, RuleSet &ruleSet);
+
+#endif // RULESET_H
@@ -0,0 +1,196 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "semanticindex.h"
+
+#include <QHash>
+#include <QtMath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Minimum cosine similarity for a command to be given to an item
+static const float minScore = 0.6f;
+
+/**
+ * Add a feature to the vector, the hash chooses the dimension and the sign
+ */
+static void addFeature(QVector<float> &vector, const QStringRef &feature, uint seed)
+{
+    uint hash = qHash(feature, seed);
+    vector[int(hash % SemanticIndex::Dimension)] += (hash & 0x80000000u) ? -1.0f : 1.0f;
+}
+
+/**
+ * Dot product of a quantized example with the quantized command
+ */
+static qint32 dotProduct(const qint8 *row, const qint16 *query)
+{
+#if defined(__SSE2__)
+    __m128i sum = _mm_setzero_si128();
+
+    for (int i = 0; i < SemanticIndex::Dimension; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + i));
+        __m128i low = _mm_srai_epi16(_mm_unpacklo_epi8(bytes, bytes), 8);
+        __m128i high = _mm_srai_epi16(_mm_unpackhi_epi8(bytes, bytes), 8);
+
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(low, _mm_loadu_si128(reinterpret_cast<const __m128i *>(query + i))));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(high, _mm_loadu_si128(reinterpret_cast<const __m128i *>(query + i + 8))));
+    }
+
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    return _mm_cvtsi128_si32(sum);
+#else
+    qint32 sum = 0;
+
+    for (int i = 0; i < SemanticIndex::Dimension; i++)
+        sum += qint32(row[i]) * qint32(query[i]);
+
+    return sum;
+#endif
+}
+
+void SemanticIndex::clear()
+{
+    matrix.clear();
+    targets.clear();
+}
+
+/**
+ * Add an example phrase of an item
+ *
+ * @param words the words of the phrase, formatted like a command
+ * @param plugin the index of the plugin
+ * @param item the index of the item in the rules of the plugin
+ */
+void SemanticIndex::add(const QList<QString> &words, int plugin, int item)
+{
+    const QVector<float> vector = embed(words);
+    if (vector.isEmpty()) return;
+
+    const int row = matrix.size();
+    matrix.resize(row + Dimension);
+
+    for (int i = 0; i < Dimension; i++)
+        matrix[row + i] = qint8(qRound(vector.at(i) * 127.0f));
+
+    targets.append(qMakePair(plugin, item));
+}
+
+/**
+ * Search the examples which are the closest to a command
+ *
+ * @param words the words of the command
+ * @param k the number of examples returned
+ * @return the k best examples, the best first
+ */
+QVector<SemanticIndex::Hit> SemanticIndex::search(const QList<QString> &words, int k) const
+{
+    QVector<Hit> hits;
+    const QVector<float> vector = embed(words);
+    if (vector.isEmpty() || targets.isEmpty()) return hits;
+
+    QVector<qint16> query(Dimension);
+    for (int i = 0; i < Dimension; i++)
+        query[i] = qint16(qRound(vector.at(i) * 127.0f));
+
+    const qint8 *row = matrix.constData();
+
+    for (int r = 0; r < targets.size(); r++, row += Dimension) {
+        float score = dotProduct(row, query.constData()) / (127.0f * 127.0f);
+
+        if (hits.size() == k && score <= hits.last().score) continue;
+
+        Hit hit;
+        hit.plugin = targets.at(r).first;
+        hit.item = targets.at(r).second;
+        hit.score = score;
+
+        int position = hits.size();
+        while (position > 0 && hits.at(position-1).score < score) position--;
+
+        hits.insert(position, hit);
+        if (hits.size() > k) hits.removeLast();
+    }
+
+    return hits;
+}
+
+/**
+ * Return the item of the closest example if it is similar enough to the command
+ *
+ * @param words the words of the command
+ * @param plugin the index of the plugin found
+ * @param item the index of the item found
+ * @return if an item has been found
+ */
+bool SemanticIndex::bestMatch(const QList<QString> &words, int *plugin, int *item) const
+{
+    const QVector<Hit> hits = search(words, 1);
+    if (hits.isEmpty() || hits.first().score < minScore) return false;
+
+    *plugin = hits.first().plugin;
+    *item = hits.first().item;
+
+    return true;
+}
+
+/**
+ * @return the number of example phrases
+ */
+int SemanticIndex::count() const
+{
+    return targets.size();
+}
+
+/**
+ * Compute the normalized vector of a phrase: its words and the trigrams of its words
+ *
+ * @return the vector, empty if the phrase has no word
+ */
+QVector<float> SemanticIndex::embed(const QList<QString> &words)
+{
+    QVector<float> vector(Dimension, 0.0f);
+    bool isEmpty = true;
+
+    for (const QString &word : words) {
+        if (word.isEmpty() || word == ",") continue;
+
+        const QString text = "#" + word + "#";
+        isEmpty = false;
+
+        addFeature(vector, QStringRef(&word), 1);
+
+        for (int i = 0; i + 3 <= text.length(); i++)
+            addFeature(vector, text.midRef(i, 3), 2);
+    }
+
+    if (isEmpty) return QVector<float>();
+
+    float norm = 0;
+    for (float value : vector) norm += value * value;
+
+    norm = qSqrt(norm);
+    if (norm == 0) return QVector<float>();
+
+    for (int i = 0; i < Dimension; i++) vector[i] /= norm;
+
+    return vector;
+}
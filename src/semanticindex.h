@@ -0,0 +1,58 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#ifndef SEMANTICINDEX_H
+#define SEMANTICINDEX_H
+
+#include <QList>
+#include <QPair>
+#include <QVector>
+#include <QString>
+
+/**
+ * Find the item of a plugin whose example phrases are the closest to a command.
+ *
+ * Each phrase is embedded as a vector of hashed character trigrams and
+ * words, normalized and quantized to 8 bits. A command is compared with
+ * all the examples by a vectorized dot product.
+ */
+class SemanticIndex
+{
+public:
+    enum { Dimension = 256, TopK = 3 };
+
+    struct Hit
+    {
+        int plugin = -1;
+        int item = -1;
+        float score = 0;
+    };
+
+    void clear();
+    void add(const QList<QString> &words, int plugin, int item);
+    QVector<Hit> search(const QList<QString> &words, int k = TopK) const;
+    bool bestMatch(const QList<QString> &words, int *plugin, int *item) const;
+    int count() const;
+
+private:
+    static QVector<float> embed(const QList<QString> &words);
+
+    QVector<qint8> matrix;
+    QVector<QPair<int, int>> targets;
+};
+
+#endif // SEMANTICINDEX_H
@@ -0,0 +1,58 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "sessionprotocol.h"
+
+#include <QJsonDocument>
+#include <QtEndian>
+
+/**
+ * @return the message preceded by its size
+ */
+QByteArray SessionProtocol::encode(const QJsonObject &message)
+{
+    QByteArray json = QJsonDocument(message).toJson(QJsonDocument::Compact);
+    QByteArray data(4, '\0');
+    qToBigEndian<quint32>(json.size(), data.data());
+
+    return data+json;
+}
+
+/**
+ * Take the first message of the data received
+ *
+ * @param buffer the data received, the message is removed from it
+ * @param message the message read
+ * @return Incomplete if more data is needed, Invalid if the data is not a message of the protocol
+ */
+SessionProtocol::Result SessionProtocol::decode(QByteArray &buffer, QJsonObject *message)
+{
+    if (buffer.size() < 4) return Incomplete;
+
+    quint32 size = qFromBigEndian<quint32>(buffer.constData());
+    if (size > MaxSize) return Invalid;
+    if (quint32(buffer.size()) < 4+size) return Incomplete;
+
+    QJsonParseError error;
+    QJsonDocument document = QJsonDocument::fromJson(buffer.mid(4, size), &error);
+    buffer.remove(0, 4+size);
+
+    if (error.error != QJsonParseError::NoError || !document.isObject()) return Invalid;
+
+    *message = document.object();
+    return Complete;
+}
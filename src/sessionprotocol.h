@@ -0,0 +1,45 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#ifndef SESSIONPROTOCOL_H
+#define SESSIONPROTOCOL_H
+
+#include <QByteArray>
+#include <QJsonObject>
+
+/**
+ * The messages exchanged with the daemon mode: a compact JSON object preceded by
+ * its size in bytes, a 32 bits big endian integer.
+ *
+ * Request: {"id": 1, "session": "kitchen", "type": "message", "text": "allume la lumière"}
+ *          type is "message", "text" (keystroke, "" for the main propositions), "action" or "close"
+ * Response: {"id": 1, "session": "kitchen", "replies": [{"type", "text", "isFin", "url", "actions"}],
+ *            "propositions": [...]}, or {"id", "session", "error"}
+ * Later replies: {"session": "kitchen", "replies": [...]}, without id, the replies a plugin sends
+ *                after the response, by a timer or a network reply, to the session which called it
+ */
+class SessionProtocol
+{
+public:
+    enum { MaxSize = 1 << 20 };
+    enum Result { Incomplete, Complete, Invalid };
+
+    static QByteArray encode(const QJsonObject &message);
+    static Result decode(QByteArray &buffer, QJsonObject *message);
+};
+
+#endif // SESSIONPROTOCOL_H
@@ -0,0 +1,89 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "sessionrecorder.h"
+
+#include <QJsonObject>
+#include <QJsonDocument>
+
+static const char *eventNames[] = { "newText", "message", "action" };
+
+/**
+ * Create the file, an existing recording is replaced
+ *
+ * @param fileName the path of the recording
+ */
+SessionRecorder::SessionRecorder(const QString &fileName) : file(fileName)
+{
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        qWarning("Cannot record the session in %s", qPrintable(fileName));
+
+    clock.start();
+}
+
+bool SessionRecorder::isOpen() const
+{
+    return file.isOpen();
+}
+
+/**
+ * Add a line to the recording, it is written immediately so that it is kept if the assistant is killed
+ *
+ * @param type the function of SwiftyWorker called
+ * @param text its argument
+ */
+void SessionRecorder::record(SessionEvent::Type type, const QString &text)
+{
+    if (!file.isOpen()) return;
+
+    QJsonObject object;
+    object.insert("t", clock.elapsed());
+    object.insert("event", eventNames[type]);
+    object.insert("text", text);
+
+    file.write(QJsonDocument(object).toJson(QJsonDocument::Compact));
+    file.write("\n");
+    file.flush();
+}
+
+/**
+ * Read a recording, the invalid lines are ignored
+ *
+ * @param input the JSON lines written by record()
+ * @return the events in the order of the file
+ */
+QList<SessionEvent> SessionRecorder::load(QIODevice *input)
+{
+    QList<SessionEvent> events;
+
+    while (!input->atEnd()) {
+        QJsonObject object = QJsonDocument::fromJson(input->readLine()).object();
+        QString name = object.value("event").toString();
+
+        for (int type = SessionEvent::NewText; type <= SessionEvent::Action; type++) {
+            if (name != QLatin1String(eventNames[type])) continue;
+
+            SessionEvent event;
+            event.type = SessionEvent::Type(type);
+            event.msecs = qint64(object.value("t").toDouble());
+            event.text = object.value("text").toString();
+            events.append(event);
+        }
+    }
+
+    return events;
+}
@@ -0,0 +1,58 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#ifndef SESSIONRECORDER_H
+#define SESSIONRECORDER_H
+
+#include <QList>
+#include <QFile>
+#include <QString>
+#include <QIODevice>
+#include <QElapsedTimer>
+
+/**
+ * A call of the interface to the engine, with its time since the start of the recording
+ */
+struct SessionEvent
+{
+    enum Type { NewText, Message, Action };
+
+    Type type = NewText;
+    qint64 msecs = 0;
+    QString text;
+};
+
+/**
+ * Record the keystrokes, the messages and the actions of the user as JSON lines
+ * {"t": msecs, "event": "newText" | "message" | "action", "text"}, replayed by SessionReplayer.
+ */
+class SessionRecorder
+{
+public:
+    explicit SessionRecorder(const QString &fileName);
+
+    bool isOpen() const;
+    void record(SessionEvent::Type type, const QString &text);
+
+    static QList<SessionEvent> load(QIODevice *input);
+
+private:
+    QFile file;
+    QElapsedTimer clock;
+};
+
+#endif // SESSIONRECORDER_H
@@ -0,0 +1,291 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "sessionreplayer.h"
+#include "engine.h"
+
+#include <QTextStream>
+#include <algorithm>
+
+/**
+ * Load the plugins in an engine running in its own thread
+ *
+ * @param speed Original to wait between the events as the user did, Max to send them without delay
+ */
+SessionReplayer::SessionReplayer(Speed speed, QObject *parent) : QObject(parent), speed(speed), timer(this)
+{
+    qRegisterMetaType<Reply>();
+
+    // The plugins are loaded by the constructor of the engine
+    QElapsedTimer startup;
+    startup.start();
+    Engine *engine = new Engine;
+    startupNsecs = startup.nsecsElapsed();
+    engineThread.setObjectName("engine");
+    engine->moveToThread(&engineThread);
+    connect(&engineThread, &QThread::finished, engine, &QObject::deleteLater);
+
+    connect(this, &SessionReplayer::message, engine, &Engine::messageReceived);
+    connect(this, &SessionReplayer::textChanged, engine, &Engine::textChanged);
+    connect(this, &SessionReplayer::addBaseProp, engine, &Engine::addBaseProp);
+    connect(this, &SessionReplayer::executeAction, engine, &Engine::executeAction);
+    connect(engine, &Engine::addProp, this, &SessionReplayer::propositionUpdated);
+    connect(engine, &Engine::removeProp, this, &SessionReplayer::propositionUpdated);
+    connect(engine, &Engine::removeAllProp, this, &SessionReplayer::propositionUpdated);
+    connect(engine, &Engine::reponseSended, this, &SessionReplayer::replyReceived);
+
+    this->engine = engine;
+    engineThread.start();
+    LagMonitor::watch(&engineThread, "engine");
+
+    timer.setSingleShot(true);
+    connect(&timer, &QTimer::timeout, this, &SessionReplayer::sendNext);
+}
+
+SessionReplayer::~SessionReplayer()
+{
+    engineThread.quit();
+    engineThread.wait();
+    LagMonitor::unwatch(&engineThread);
+}
+
+/**
+ * Replay all the events and write the report
+ *
+ * @param events the recording
+ * @param output the latencies in milliseconds
+ * @return 0, the exit code of the replay mode
+ */
+int SessionReplayer::run(const QList<SessionEvent> &events, QIODevice *output)
+{
+    this->events = events;
+    sentAt.fill(-1, events.length());
+    lastUpdate.fill(-1, events.length());
+    firstReply.fill(-1, events.length());
+    next = 0;
+    current = -1;
+    lastMessage = -1;
+
+    clock.start();
+    QMetaObject::invokeMethod(this, &SessionReplayer::sendNext, Qt::QueuedConnection);
+    loop.exec();
+
+    report(output);
+
+    return 0;
+}
+
+/**
+ * Send the next event, or wait until its time at the original speed
+ */
+void SessionReplayer::sendNext()
+{
+    waitingReply = false;
+
+    if (next >= events.length()) {
+        loop.quit();
+        return;
+    }
+
+    if (speed == Original) {
+        qint64 delay = events.at(next).msecs - clock.elapsed();
+
+        if (delay > 0) {
+            timer.start(int(delay));
+            return;
+        }
+    }
+
+    dispatch(next++);
+
+    // The end of the replay is handled by processed()
+    if (speed == Original && next < events.length()) QMetaObject::invokeMethod(this, &SessionReplayer::sendNext, Qt::QueuedConnection);
+}
+
+/**
+ * Send an event to the engine between two markers: what the engine sends after the
+ * first one is caused by this event, the second one tells that the engine has processed it
+ */
+void SessionReplayer::dispatch(int index)
+{
+    const SessionEvent &event = events.at(index);
+
+    QMetaObject::invokeMethod(engine, [this, index]() {
+        QMetaObject::invokeMethod(this, [this, index]() { started(index); }, Qt::QueuedConnection);
+    }, Qt::QueuedConnection);
+
+    sentAt[index] = clock.nsecsElapsed();
+
+    switch (event.type) {
+    case SessionEvent::NewText:
+        if (event.text != "") {
+            Tracer::hopSent("newText");
+            emit textChanged(event.text);
+        }
+        else {
+            emit addBaseProp();
+        }
+        break;
+    case SessionEvent::Message:
+        Tracer::hopSent("message");
+        emit message(event.text);
+        break;
+    case SessionEvent::Action:
+        Tracer::hopSent("action");
+        emit executeAction(event.text);
+        break;
+    }
+
+    QMetaObject::invokeMethod(engine, [this, index]() {
+        QMetaObject::invokeMethod(this, [this, index]() { processed(index); }, Qt::QueuedConnection);
+    }, Qt::QueuedConnection);
+}
+
+void SessionReplayer::started(int index)
+{
+    current = index;
+    if (events.at(index).type == SessionEvent::Message) lastMessage = index;
+}
+
+/**
+ * At the maximum speed, send the next event once the engine has processed this one
+ * and sent the first reply of a message, or after ReplyTimeout
+ */
+void SessionReplayer::processed(int index)
+{
+    if (speed != Max) {
+        if (index == events.length()-1) {
+            waitingReply = events.at(index).type == SessionEvent::Message && firstReply.at(index) < 0;
+            if (waitingReply) timer.start(ReplyTimeout);
+            else loop.quit();
+        }
+        return;
+    }
+
+    if (events.at(index).type == SessionEvent::Message && firstReply.at(index) < 0) {
+        waitingReply = true;
+        timer.start(ReplyTimeout);
+    }
+    else {
+        sendNext();
+    }
+}
+
+void SessionReplayer::propositionUpdated()
+{
+    if (current >= 0 && events.at(current).type == SessionEvent::NewText)
+        lastUpdate[current] = clock.nsecsElapsed();
+}
+
+void SessionReplayer::replyReceived(const Reply &reply)
+{
+    Q_UNUSED(reply)
+    Tracer::hopReceived("reply");
+
+    if (lastMessage < 0 || firstReply.at(lastMessage) >= 0) return;
+
+    firstReply[lastMessage] = clock.nsecsElapsed();
+
+    if (waitingReply) {
+        timer.stop();
+        sendNext();
+    }
+}
+
+/**
+ * @return "n, p50, p90, p99 and max" of the latencies in milliseconds
+ */
+static QString summary(const QVector<qint64> &latencies)
+{
+    if (latencies.isEmpty()) return "0";
+
+    auto format = [&latencies](int p) {
+        return QString::number(PerfResults::percentile(latencies, p) / 1e6, 'f', 3);
+    };
+
+    return QString("%1, p50 %2, p90 %3, p99 %4, max %5").arg(latencies.length())
+            .arg(format(50), format(90), format(99), format(100));
+}
+
+/**
+ * Compute the sorted latencies of the keystrokes and the messages in nanoseconds
+ */
+void SessionReplayer::latencies(QVector<qint64> &keystrokes, QVector<qint64> &messages, int &withoutUpdate, int &withoutReply) const
+{
+    withoutUpdate = 0;
+    withoutReply = 0;
+
+    for (int i = 0; i < events.length(); i++) {
+        if (sentAt.at(i) < 0) continue;
+
+        if (events.at(i).type == SessionEvent::NewText) {
+            if (lastUpdate.at(i) >= 0) keystrokes.append(lastUpdate.at(i) - sentAt.at(i));
+            else withoutUpdate++;
+        }
+        else if (events.at(i).type == SessionEvent::Message) {
+            if (firstReply.at(i) >= 0) messages.append(firstReply.at(i) - sentAt.at(i));
+            else withoutReply++;
+        }
+    }
+
+    std::sort(keystrokes.begin(), keystrokes.end());
+    std::sort(messages.begin(), messages.end());
+}
+
+void SessionReplayer::report(QIODevice *output) const
+{
+    QVector<qint64> keystrokes;
+    QVector<qint64> messages;
+    int withoutUpdate;
+    int withoutReply;
+    latencies(keystrokes, messages, withoutUpdate, withoutReply);
+
+    QTextStream out(output);
+    out << "engine startup: " << QString::number(startupNsecs / 1e6, 'f', 3) << " ms\n";
+    out << "events: " << events.length() << ", replayed in " << QString::number(clock.elapsed() / 1e3, 'f', 3) << " s\n";
+    out << "keystroke -> last proposition update (ms): " << summary(keystrokes) << ", without update " << withoutUpdate << "\n";
+    out << "message -> first reply (ms): " << summary(messages) << ", without reply " << withoutReply << "\n";
+}
+
+/**
+ * Add the results of the replay for tools/perfbaseline: the startup of the engine, the
+ * percentiles of the latencies, the events without update or reply and the peak memory
+ */
+void SessionReplayer::addResults(PerfResults &results) const
+{
+    QVector<qint64> keystrokes;
+    QVector<qint64> messages;
+    int withoutUpdate;
+    int withoutReply;
+    latencies(keystrokes, messages, withoutUpdate, withoutReply);
+
+    results.add("replay.startup", startupNsecs / 1e6, "ms");
+
+    const QList<int> percentiles = QList<int>() << 50 << 90 << 99 << 100;
+
+    foreach (int p , percentiles) {
+        const QString name = p == 100 ? "max" : "p"+QString::number(p);
+        if (!keystrokes.isEmpty()) results.add("replay.keystroke."+name, PerfResults::percentile(keystrokes, p) / 1e6, "ms");
+        if (!messages.isEmpty()) results.add("replay.message."+name, PerfResults::percentile(messages, p) / 1e6, "ms");
+    }
+
+    results.add("replay.keystroke.without_update", withoutUpdate, "events");
+    results.add("replay.message.without_reply", withoutReply, "events");
+
+    qint64 rss = PerfResults::peakRss();
+    if (rss >= 0) results.add("replay.peak_rss", rss, "bytes");
+}
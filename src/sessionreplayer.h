@@ -0,0 +1,92 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#ifndef SESSIONREPLAYER_H
+#define SESSIONREPLAYER_H
+
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+#include <QVector>
+#include <QEventLoop>
+#include <QElapsedTimer>
+#include <QIODevice>
+
+#include "sessionrecorder.h"
+#include "perfresults.h"
+#include "reply.h"
+
+/**
+ * Replay a recording of SessionRecorder in an engine without interface and report the latencies:
+ * from a keystroke to the last proposition update it caused, and from a message to its first reply.
+ *
+ * An event is followed by the propositions and the replies sent by the engine until the next
+ * event starts in the engine thread. At the maximum speed, the next event is sent as soon as
+ * the engine has processed the previous one and, for a message, sent its first reply.
+ */
+class SessionReplayer : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Speed { Original, Max };
+    enum { ReplyTimeout = 5000 };
+
+    explicit SessionReplayer(Speed speed, QObject *parent = nullptr);
+    ~SessionReplayer();
+
+    int run(const QList<SessionEvent> &events, QIODevice *output);
+    void addResults(PerfResults &results) const;
+
+signals:
+    void message(QString message);
+    void textChanged(QString text);
+    void addBaseProp();
+    void executeAction(QString action);
+
+private slots:
+    void sendNext();
+    void propositionUpdated();
+    void replyReceived(const Reply &reply);
+
+private:
+    void dispatch(int index);
+    void started(int index);
+    void processed(int index);
+    void report(QIODevice *output) const;
+    void latencies(QVector<qint64> &keystrokes, QVector<qint64> &messages, int &withoutUpdate, int &withoutReply) const;
+
+    QThread engineThread;
+    QObject *engine = nullptr;
+    Speed speed;
+    qint64 startupNsecs = 0;
+
+    QList<SessionEvent> events;
+    QVector<qint64> sentAt;
+    QVector<qint64> lastUpdate;
+    QVector<qint64> firstReply;
+    int next = 0;
+    int current = -1;
+    int lastMessage = -1;
+    bool waitingReply = false;
+
+    QElapsedTimer clock;
+    QTimer timer;
+    QEventLoop loop;
+};
+
+#endif // SESSIONREPLAYER_H
@@ -0,0 +1,323 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "sessionserver.h"
+#include "sessionprotocol.h"
+#include "engine.h"
+
+#include <QMetaEnum>
+#include <QStringList>
+
+#include <algorithm>
+
+//===================================================
+//===================== Worker ======================
+//===================================================
+
+/**
+ * @param source the engine which has loaded the plugins
+ */
+SessionWorker::SessionWorker(const Engine *source, QObject *parent) : QObject(parent)
+{
+    engine = new Engine(source, this);
+
+    connect(engine, &Engine::reponseSended, this, [this](const Reply &reply) { replies.append(reply); });
+    connect(engine, &Engine::pluginSignalAfterRequest, this, &SessionWorker::handlePluginSignal);
+}
+
+/**
+ * Run a request in the conversation of its session, the session is created by its first request
+ *
+ * @param key the connection and the session of the request
+ * @param request see SessionProtocol
+ * @return the replies sent by the engine for the request and the propositions shown after it
+ */
+QJsonObject SessionWorker::handle(const QString &key, const QJsonObject &request)
+{
+    const QString type = request.value("type").toString();
+    const QString text = request.value("text").toString();
+
+    QJsonObject response;
+    response.insert("id", request.value("id"));
+    response.insert("session", request.value("session"));
+
+    if (type == "close") {
+        sessions.remove(key);
+        response.insert("closed", true);
+        return response;
+    }
+
+    if (type != "message" && type != "text" && type != "action") {
+        response.insert("error", "Unknown request type: "+type);
+        return response;
+    }
+
+    if (!sessions.contains(key)) {
+        sessions.insert(key, engine->newConversation());
+        sessions[key].session = key;
+    }
+
+    Conversation *conversation = &sessions[key];
+    replies.clear();
+    engine->setConversation(conversation);
+
+    if (type == "message") engine->messageReceived(text);
+    else if (type == "action") engine->executeAction(text);
+    else if (text.isEmpty()) engine->addBaseProp();
+    else engine->textChanged(text);
+
+    // The actions found for the request are executed before the response is sent
+    engine->runActions();
+    engine->setConversation(nullptr);
+
+    response.insert("replies", takeReplies());
+    response.insert("propositions", QJsonArray::fromStringList(QStringList(conversation->showedProp)));
+
+    return response;
+}
+
+/**
+ * Run a signal a plugin has sent after the response of a request, in the session which made the call.
+ * The replies it sends are given to the client without id, see SessionProtocol.
+ *
+ * @param key the connection and the session of the call
+ * @param slot the call of the slot of the engine which receives the signal
+ */
+void SessionWorker::handlePluginSignal(const QString &key, const std::function<void()> &slot)
+{
+    // The session has been closed since the call
+    if (!sessions.contains(key)) return;
+
+    replies.clear();
+    engine->setConversation(&sessions[key]);
+
+    slot();
+
+    engine->runActions();
+    engine->setConversation(nullptr);
+
+    if (!replies.isEmpty()) emit repliesSendedLater(key, takeReplies());
+}
+
+/**
+ * Remove the sessions of a connection
+ *
+ * @param prefix "<connection>/"
+ */
+void SessionWorker::closeSessions(const QString &prefix)
+{
+    for (auto it = sessions.begin(); it != sessions.end();) {
+        if (it.key().startsWith(prefix)) it = sessions.erase(it);
+        else ++it;
+    }
+}
+
+QJsonArray SessionWorker::takeReplies()
+{
+    QJsonArray jsonReplies;
+    foreach (Reply reply , replies) jsonReplies.append(toJson(reply));
+    replies.clear();
+
+    return jsonReplies;
+}
+
+QJsonObject SessionWorker::toJson(const Reply &reply)
+{
+    QJsonArray actions;
+    foreach (ReplyAction action , reply.actions()) actions.append(QJsonArray() << action.first << action.second);
+
+    QJsonObject object;
+    object.insert("type", QMetaEnum::fromType<Reply::Type>().valueToKey(reply.type()));
+    object.insert("text", reply.text());
+    object.insert("isFin", reply.isFin());
+    object.insert("url", reply.url());
+    object.insert("actions", actions);
+
+    return object;
+}
+
+//===================================================
+//===================== Server ======================
+//===================================================
+
+/**
+ * Load the plugins and start the workers
+ *
+ * @param workers the number of engine threads
+ */
+SessionServer::SessionServer(int workers, QObject *parent) : QObject(parent), server(this)
+{
+    qRegisterMetaType<Reply>();
+
+    source = new Engine;
+    source->setWorkerMode();
+
+    for (int i = 0; i < qMax(1, workers); i++) {
+        QThread *thread = new QThread;
+        SessionWorker *worker = new SessionWorker(source);
+
+        thread->setObjectName("daemon "+QString::number(i));
+        worker->moveToThread(thread);
+        connect(thread, &QThread::finished, worker, &QObject::deleteLater);
+        connect(worker, &SessionWorker::repliesSendedLater, this, &SessionServer::sendLateReplies);
+        thread->start();
+
+        threads.append(thread);
+        this->workers.append(worker);
+    }
+
+    sessionCounts.fill(0, this->workers.length());
+
+    connect(&server, &QLocalServer::newConnection, this, &SessionServer::newConnection);
+}
+
+SessionServer::~SessionServer()
+{
+    foreach (QThread *thread , threads) {
+        thread->quit();
+        thread->wait();
+    }
+
+    qDeleteAll(threads);
+
+    // The workers used the plugins and the rules of the source engine
+    delete source;
+}
+
+/**
+ * @param name the name of the local socket, a path or a name in the folder of the sockets of the system
+ * @return false if the server cannot listen
+ */
+bool SessionServer::listen(const QString &name)
+{
+    QLocalServer::removeServer(name);
+
+    if (!server.listen(name)) {
+        qCritical("Cannot listen on %s: %s", qPrintable(name), qPrintable(server.errorString()));
+        return false;
+    }
+
+    qInfo("Listening on %s with %d workers", qPrintable(server.fullServerName()), workers.length());
+
+    return true;
+}
+
+void SessionServer::newConnection()
+{
+    while (QLocalSocket *socket = server.nextPendingConnection()) {
+        const quint64 id = nextConnection++;
+        connections[id].socket = socket;
+
+        connect(socket, &QLocalSocket::readyRead, this, [this, id]() { readRequests(id); });
+        connect(socket, &QLocalSocket::disconnected, this, [this, id]() { closeConnection(id); });
+    }
+}
+
+void SessionServer::readRequests(quint64 id)
+{
+    if (!connections.contains(id)) return;
+
+    Connection &connection = connections[id];
+    connection.buffer.append(connection.socket->readAll());
+
+    QJsonObject request;
+    SessionProtocol::Result result = SessionProtocol::Incomplete;
+
+    while ((result = SessionProtocol::decode(connection.buffer, &request)) == SessionProtocol::Complete)
+        dispatch(id, request);
+
+    if (result == SessionProtocol::Invalid) {
+        qWarning("Invalid request, the connection %llu is closed", id);
+        connection.socket->disconnectFromServer();
+    }
+}
+
+/**
+ * Give a request to the worker of its session
+ */
+void SessionServer::dispatch(quint64 id, const QJsonObject &request)
+{
+    const QString key = QString::number(id)+"/"+request.value("session").toString();
+    int index = sessionWorkers.value(key, -1);
+
+    // A session stays with its worker, see SessionServer
+    if (index < 0) {
+        index = int(std::min_element(sessionCounts.begin(), sessionCounts.end()) - sessionCounts.begin());
+        sessionWorkers.insert(key, index);
+        sessionCounts[index]++;
+    }
+
+    if (request.value("type").toString() == "close") {
+        sessionWorkers.remove(key);
+        sessionCounts[index]--;
+    }
+
+    SessionWorker *worker = workers.at(index);
+
+    QMetaObject::invokeMethod(worker, [this, worker, id, key, request]() {
+        QJsonObject response = worker->handle(key, request);
+        QMetaObject::invokeMethod(this, [this, id, response]() { send(id, response); }, Qt::QueuedConnection);
+    }, Qt::QueuedConnection);
+}
+
+void SessionServer::send(quint64 id, const QJsonObject &response)
+{
+    if (!connections.contains(id)) return;
+
+    connections.value(id).socket->write(SessionProtocol::encode(response));
+}
+
+/**
+ * Send the replies a plugin has sent after the response of the request of a session
+ *
+ * @param key the connection and the session
+ * @param replies the replies
+ */
+void SessionServer::sendLateReplies(const QString &key, const QJsonArray &replies)
+{
+    QJsonObject message;
+    message.insert("session", key.section('/', 1));
+    message.insert("replies", replies);
+
+    send(key.section('/', 0, 0).toULongLong(), message);
+}
+
+/**
+ * Forget a closed connection and its sessions
+ */
+void SessionServer::closeConnection(quint64 id)
+{
+    if (!connections.contains(id)) return;
+
+    connections.take(id).socket->deleteLater();
+
+    const QString prefix = QString::number(id)+"/";
+
+    for (auto it = sessionWorkers.begin(); it != sessionWorkers.end();) {
+        if (it.key().startsWith(prefix)) {
+            sessionCounts[it.value()]--;
+            it = sessionWorkers.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    foreach (SessionWorker *worker , workers) {
+        QMetaObject::invokeMethod(worker, [worker, prefix]() { worker->closeSessions(prefix); }, Qt::QueuedConnection);
+    }
+}
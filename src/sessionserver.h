@@ -0,0 +1,111 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#ifndef SESSIONSERVER_H
+#define SESSIONSERVER_H
+
+#include <QObject>
+#include <QThread>
+#include <QHash>
+#include <QVector>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QLocalServer>
+#include <QLocalSocket>
+
+#include "conversation.h"
+#include "reply.h"
+
+#include <functional>
+
+class Engine;
+
+/**
+ * The sessions served by one engine thread of the daemon. A session is always served by the
+ * same worker, so its requests are handled in order and its conversation is only used by one thread.
+ */
+class SessionWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SessionWorker(const Engine *source, QObject *parent = nullptr);
+
+    QJsonObject handle(const QString &key, const QJsonObject &request);
+    void closeSessions(const QString &prefix);
+
+private:
+    void handlePluginSignal(const QString &key, const std::function<void()> &slot);
+    QJsonArray takeReplies();
+    static QJsonObject toJson(const Reply &reply);
+
+    Engine *engine;
+    QHash<QString, Conversation> sessions;
+    QList<Reply> replies;
+
+signals:
+    void repliesSendedLater(const QString &key, const QJsonArray &replies);
+};
+
+/**
+ * The daemon mode: the clients connect to a QLocalServer and open as many sessions as they
+ * want, see SessionProtocol. The plugins are loaded once and their rules are shared by the
+ * engines of the workers, each one in its own thread. A new session goes to the worker
+ * which has the fewest sessions.
+ *
+ * The workers are threads of their own rather than tasks of a QThreadPool because a session
+ * stays with its engine: the engine keeps a cache of matches and an arena which are not shared
+ * between threads, the conversation of the session is used without lock, and the signals
+ * a plugin sends after a request go to the engine which called it, see PluginRelay.
+ */
+class SessionServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SessionServer(int workers = QThread::idealThreadCount(), QObject *parent = nullptr);
+    ~SessionServer();
+
+    bool listen(const QString &name);
+
+private slots:
+    void newConnection();
+
+private:
+    struct Connection
+    {
+        QLocalSocket *socket = nullptr;
+        QByteArray buffer;
+    };
+
+    void readRequests(quint64 id);
+    void dispatch(quint64 id, const QJsonObject &request);
+    void send(quint64 id, const QJsonObject &response);
+    void sendLateReplies(const QString &key, const QJsonArray &replies);
+    void closeConnection(quint64 id);
+
+    QLocalServer server;
+    Engine *source;
+    QList<QThread *> threads;
+    QList<SessionWorker *> workers;
+    QVector<int> sessionCounts;
+    QHash<QString, int> sessionWorkers;
+    QHash<quint64, Connection> connections;
+    quint64 nextConnection = 1;
+};
+
+#endif // SESSIONSERVER_H
@@ -0,0 +1,307 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "slotparser.h"
+
+#include <QHash>
+#include <QRegularExpression>
+
+/**
+ * @return the numbers written in letters
+ */
+static const QHash<QString, int> &numberWords()
+{
+    static const QHash<QString, int> words {
+        {"zero", 0}, {"un", 1}, {"une", 1}, {"deux", 2}, {"trois", 3}, {"quatre", 4}, {"cinq", 5},
+        {"six", 6}, {"sept", 7}, {"huit", 8}, {"neuf", 9}, {"dix", 10}, {"onze", 11}, {"douze", 12},
+        {"treize", 13}, {"quatorze", 14}, {"quinze", 15}, {"seize", 16}, {"vingt", 20}, {"trente", 30},
+        {"quarante", 40}, {"cinquante", 50}, {"soixante", 60}, {"cent", 100}, {"mille", 1000}
+    };
+
+    return words;
+}
+
+/**
+ * @return the duration units in seconds
+ */
+static const QHash<QString, int> &durationUnits()
+{
+    static const QHash<QString, int> units {
+        {"s", 1}, {"sec", 1}, {"seconde", 1}, {"secondes", 1},
+        {"mn", 60}, {"min", 60}, {"minute", 60}, {"minutes", 60},
+        {"h", 3600}, {"heure", 3600}, {"heures", 3600},
+        {"jour", 86400}, {"jours", 86400}, {"semaine", 604800}, {"semaines", 604800}
+    };
+
+    return units;
+}
+
+/**
+ * @return the days of the week, 1 for monday as QDate::dayOfWeek
+ */
+static const QHash<QString, int> &weekDays()
+{
+    static const QHash<QString, int> days {
+        {"lundi", 1}, {"mardi", 2}, {"mercredi", 3}, {"jeudi", 4}, {"vendredi", 5}, {"samedi", 6}, {"dimanche", 7}
+    };
+
+    return days;
+}
+
+/**
+ * Read the value of a slot at a position of the command
+ *
+ * @param type the type of the slot
+ * @param words the words list of the command
+ * @param from the index of the first word
+ * @param value set to the value found: a number, a duration in seconds or a QDateTime
+ * @param now the date used for the relative dates ("demain", "lundi"...)
+ * @return the number of words used by the value, 0 if there is no value at this position
+ */
+int SlotParser::read(RuleVar::Type type, const QList<QString> &words, int from, QVariant *value, const QDateTime &now)
+{
+    if (from < 0 || from >= words.length()) return 0;
+
+    int length = 0;
+
+    if (type == RuleVar::Number) {
+        double number = 0;
+        length = readNumber(words, from, &number);
+
+        if (length > 0 && value) {
+            if (number == qRound64(number)) *value = qRound64(number);
+            else *value = number;
+        }
+    }
+    else if (type == RuleVar::Duration) {
+        qint64 seconds = 0;
+        length = readDuration(words, from, &seconds);
+        if (length > 0 && value) *value = seconds;
+    }
+    else if (type == RuleVar::DateTime) {
+        QDateTime dateTime;
+        length = readDateTime(words, from, now, &dateTime);
+        if (length > 0 && value) *value = dateTime;
+    }
+    else {
+        length = 1;
+        if (value) *value = words.at(from);
+    }
+
+    return length;
+}
+
+/**
+ * Convert the words of a slot found by RuleItem::extractVars to its typed value
+ *
+ * @param type the type of the slot
+ * @param text the words of the slot
+ * @param now the date used for the relative dates
+ * @return the value, the text itself for the text and enum slots
+ */
+QVariant SlotParser::value(RuleVar::Type type, const QString &text, const QDateTime &now)
+{
+    if (type == RuleVar::Text || type == RuleVar::Enum) return text;
+
+    QVariant result;
+    read(type, text.split(' ', Qt::SkipEmptyParts), 0, &result, now);
+
+    return result;
+}
+
+/**
+ * Write a slot value in a reply or an action
+ *
+ * @param value the value returned by SlotParser::value
+ * @return the text of the value, ISO 8601 for a date
+ */
+QString SlotParser::toText(const QVariant &value)
+{
+    if (value.type() == QVariant::DateTime) return value.toDateTime().toString(Qt::ISODate);
+
+    return value.toString();
+}
+
+int SlotParser::readNumber(const QList<QString> &words, int from, double *number)
+{
+    bool isNumber = false;
+    double digits = words.at(from).toDouble(&isNumber);
+
+    if (isNumber) {
+        *number = digits;
+        return 1;
+    }
+
+    const QHash<QString, int> &numbers = numberWords();
+    qint64 total = 0;
+    qint64 current = 0;
+    int i = from;
+
+    while (i < words.length()) {
+        // "vingt et un"
+        if (words.at(i) == "et" && i > from && i+1 < words.length() && numbers.contains(words.at(i+1))) {
+            i++;
+            continue;
+        }
+
+        auto word = numbers.constFind(words.at(i));
+        if (word == numbers.constEnd()) break;
+
+        if (word.value() == 100) current = (current == 0 ? 1 : current) * 100;
+        else if (word.value() == 1000) { total += (current == 0 ? 1 : current) * 1000; current = 0; }
+        else current += word.value();
+
+        i++;
+    }
+
+    *number = total + current;
+
+    return i - from;
+}
+
+int SlotParser::readDuration(const QList<QString> &words, int from, qint64 *seconds)
+{
+    static const QRegularExpression compact("^(\\d+)(h|mn|min|s|sec)(\\d+)?$");
+    const QHash<QString, int> &units = durationUnits();
+    qint64 total = 0;
+    int i = from;
+
+    while (i < words.length()) {
+        QRegularExpressionMatch match = compact.match(words.at(i));
+
+        // "5min", "1h30"
+        if (match.hasMatch()) {
+            int unit = units.value(match.captured(2));
+            total += match.captured(1).toLongLong() * unit;
+            if (!match.captured(3).isEmpty()) total += match.captured(3).toLongLong() * (unit == 3600 ? 60 : 1);
+            i++;
+            continue;
+        }
+
+        // "une heure et demie"
+        if (total > 0 && words.at(i) == "et" && i+1 < words.length() && (words.at(i+1) == "demi" || words.at(i+1) == "demie")) {
+            int unit = units.value(words.at(i-1), 0);
+            total += unit / 2;
+            i += 2;
+            continue;
+        }
+
+        // "une heure et dix minutes"
+        if (total > 0 && words.at(i) == "et") {
+            qint64 next = 0;
+            if (i+1 == words.length() || readDuration(words, i+1, &next) == 0) break;
+
+            i++;
+            continue;
+        }
+
+        double number = 0;
+        int length = readNumber(words, i, &number);
+
+        if (length == 0 || i+length >= words.length() || !units.contains(words.at(i+length))) break;
+
+        total += qRound64(number * units.value(words.at(i+length)));
+        i += length+1;
+    }
+
+    *seconds = total;
+
+    return total > 0 ? i - from : 0;
+}
+
+int SlotParser::readTime(const QList<QString> &words, int from, QTime *time)
+{
+    static const QRegularExpression compact("^(\\d{1,2})(?:h|:)(\\d{2})?$");
+
+    if (words.at(from) == "midi") { *time = QTime(12, 0); return 1; }
+    if (words.at(from) == "minuit") { *time = QTime(0, 0); return 1; }
+
+    QRegularExpressionMatch match = compact.match(words.at(from));
+
+    // "14h", "14h30", "14:30"
+    if (match.hasMatch()) {
+        *time = QTime(match.captured(1).toInt(), match.captured(2).toInt());
+        return time->isValid() ? 1 : 0;
+    }
+
+    // "14 heures 30"
+    double hour = 0;
+    int length = readNumber(words, from, &hour);
+    int i = from+length;
+
+    if (length == 0 || i >= words.length() || (words.at(i) != "heure" && words.at(i) != "heures" && words.at(i) != "h"))
+        return 0;
+
+    i++;
+    double minute = 0;
+    int minuteLength = i < words.length() ? readNumber(words, i, &minute) : 0;
+    i += minuteLength;
+
+    *time = QTime(int(hour), int(minute));
+
+    return time->isValid() ? i - from : 0;
+}
+
+int SlotParser::readDateTime(const QList<QString> &words, int from, const QDateTime &now, QDateTime *dateTime)
+{
+    QDate date;
+    QTime time;
+    int i = from;
+
+    while (i < words.length()) {
+        const QString &word = words.at(i);
+
+        if (!date.isValid() && (word == "aujourd'hui" || word == "aujourdhui")) {
+            date = now.date();
+            i++;
+        }
+        else if (!date.isValid() && word == "demain") {
+            date = now.date().addDays(1);
+            i++;
+        }
+        else if (!date.isValid() && word == "apres" && i+1 < words.length() && words.at(i+1) == "demain") {
+            date = now.date().addDays(2);
+            i += 2;
+        }
+        else if (!date.isValid() && weekDays().contains(word)) {
+            int days = weekDays().value(word) - now.date().dayOfWeek();
+            date = now.date().addDays(days <= 0 ? days+7 : days);
+            i++;
+        }
+        else if (!time.isValid() && (word == "a" || word == "vers") && i+1 < words.length() && readTime(words, i+1, &time) > 0) {
+            i += 1 + readTime(words, i+1, &time);
+        }
+        else if (!time.isValid() && readTime(words, i, &time) > 0) {
+            i += readTime(words, i, &time);
+        }
+        else {
+            break;
+        }
+    }
+
+    if (!date.isValid() && !time.isValid()) return 0;
+
+    if (!date.isValid()) {
+        // An hour already passed is for tomorrow
+        date = time > now.time() ? now.date() : now.date().addDays(1);
+    }
+    if (!time.isValid()) time = QTime(0, 0);
+
+    *dateTime = QDateTime(date, time);
+
+    return i - from;
+}
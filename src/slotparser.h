@@ -0,0 +1,50 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#ifndef SLOTPARSER_H
+#define SLOTPARSER_H
+
+#include <QList>
+#include <QString>
+#include <QVariant>
+#include <QDateTime>
+
+#include "ruleset.h"
+
+/**
+ * Recognize the value of a typed <Slot> in the words of a command.
+ *
+ * The words are lower case and without accents (see Engine::format), so
+ * "dans cinq minutes" gives 300 for a duration and "demain a 14h30"
+ * gives the corresponding QDateTime for a datetime.
+ */
+class SlotParser
+{
+public:
+    static int read(RuleVar::Type type, const QList<QString> &words, int from,
+                    QVariant *value = nullptr, const QDateTime &now = QDateTime::currentDateTime());
+    static QVariant value(RuleVar::Type type, const QString &text, const QDateTime &now = QDateTime::currentDateTime());
+    static QString toText(const QVariant &value);
+
+private:
+    static int readNumber(const QList<QString> &words, int from, double *number);
+    static int readDuration(const QList<QString> &words, int from, qint64 *seconds);
+    static int readDateTime(const QList<QString> &words, int from, const QDateTime &now, QDateTime *dateTime);
+    static int readTime(const QList<QString> &words, int from, QTime *time);
+};
+
+#endif // SLOTPARSER_H
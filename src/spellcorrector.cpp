@@ -0,0 +1,176 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "spellcorrector.h"
+
+#include <QtAlgorithms>
+
+#include <memory_resource>
+#include <vector>
+
+/**
+ * Build the deletion dictionary from the vocabulary of all the plugins
+ *
+ * @param ruleSets the compiled rules of the plugins
+ */
+void SpellCorrector::build(const QList<RuleSet> &ruleSets)
+{
+    dictionary.clear();
+    words.clear();
+    deletes.clear();
+
+    for (const RuleSet &ruleSet : ruleSets) {
+        for (const QString &word : ruleSet.vocabulary) {
+            if (word.contains(' ') || words.contains(word)) continue;
+
+            words.insert(word);
+
+            if (word.length() < MinWordLength) continue;
+
+            int index = dictionary.length();
+            dictionary.append(word);
+
+            QSet<QString> wordDeletes;
+            wordDeletes.insert(word.left(PrefixLength));
+            addDeletes(word.left(PrefixLength), MaxDistance, &wordDeletes);
+
+            for (const QString &deletion : wordDeletes)
+                deletes[deletion].append(index);
+        }
+    }
+}
+
+/**
+ * Return the nearest word of the vocabulary
+ *
+ * @param word a word of the user
+ * @return the corrected word, or the word itself if it is known or too far from the vocabulary
+ */
+QString SpellCorrector::correct(const QString &word) const
+{
+    if (word.length() < MinWordLength || words.contains(word)) return word;
+
+    const int max = maxDistance(word);
+    const QString prefix = word.left(PrefixLength);
+
+    QSet<QString> candidates;
+    candidates.insert(prefix);
+    addDeletes(prefix, max, &candidates);
+
+    int bestIndex = -1;
+    int bestDistance = max+1;
+
+    for (const QString &candidate : candidates) {
+        const QVector<int> indexes = deletes.value(candidate);
+
+        for (int index : indexes) {
+            const QString &suggestion = dictionary.at(index);
+            if (qAbs(suggestion.length() - word.length()) > max) continue;
+
+            int distance = editDistance(word, suggestion, max);
+
+            if (distance < bestDistance || (distance == bestDistance && index < bestIndex)) {
+                bestDistance = distance;
+                bestIndex = index;
+            }
+        }
+    }
+
+    return bestIndex == -1 ? word : dictionary.at(bestIndex);
+}
+
+/**
+ * Correct all the words of a command
+ *
+ * @param cmd the words list of the command
+ */
+QList<QString> SpellCorrector::correct(const QList<QString> &cmd) const
+{
+    QList<QString> corrected;
+    corrected.reserve(cmd.length());
+
+    for (const QString &word : cmd)
+        corrected.append(correct(word));
+
+    return corrected;
+}
+
+/**
+ * One mistake is accepted in short words, two in words of eight characters or more
+ */
+int SpellCorrector::maxDistance(const QString &word)
+{
+    return word.length() >= 8 ? MaxDistance : 1;
+}
+
+void SpellCorrector::addDeletes(const QString &text, int distance, QSet<QString> *deletes)
+{
+    if (distance == 0 || text.length() <= 1) return;
+
+    for (int i = 0; i < text.length(); i++) {
+        QString deletion = text;
+        deletion.remove(i, 1);
+
+        if (!deletes->contains(deletion)) {
+            deletes->insert(deletion);
+            addDeletes(deletion, distance-1, deletes);
+        }
+    }
+}
+
+/**
+ * Damerau-Levenshtein distance (optimal string alignment)
+ *
+ * @return the distance, or max+1 if it is greater than max
+ */
+int SpellCorrector::editDistance(const QString &a, const QString &b, int max)
+{
+    const int n = a.length();
+    const int m = b.length();
+
+    // The rows of the usual words fit in the stack
+    int buffer[3 * 32];
+    std::pmr::monotonic_buffer_resource memory(buffer, sizeof(buffer));
+
+    std::pmr::vector<int> previous2(m+1, 0, &memory);
+    std::pmr::vector<int> previous(m+1, 0, &memory);
+    std::pmr::vector<int> current(m+1, 0, &memory);
+
+    for (int j = 0; j <= m; j++) previous[j] = j;
+
+    for (int i = 1; i <= n; i++) {
+        current[0] = i;
+        int rowMin = current[0];
+
+        for (int j = 1; j <= m; j++) {
+            int cost = a.at(i-1) == b.at(j-1) ? 0 : 1;
+            current[j] = qMin(qMin(previous[j]+1, current[j-1]+1), previous[j-1]+cost);
+
+            if (i > 1 && j > 1 && a.at(i-1) == b.at(j-2) && a.at(i-2) == b.at(j-1))
+                current[j] = qMin(current[j], previous2[j-2]+1);
+
+            rowMin = qMin(rowMin, current[j]);
+        }
+
+        if (rowMin > max) return max+1;
+
+        previous2.swap(previous);
+        previous.swap(current);
+    }
+
+    return qMin(previous[m], max+1);
+}
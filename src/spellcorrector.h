@@ -0,0 +1,56 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#ifndef SPELLCORRECTOR_H
+#define SPELLCORRECTOR_H
+
+#include <QSet>
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include <QString>
+
+#include "ruleset.h"
+
+/**
+ * Correct the typing mistakes of the user with the words used by the rules of the plugins.
+ *
+ * Every word of the vocabulary is stored under all the strings obtained by
+ * deleting up to two characters of its prefix (symmetric delete). A word
+ * of the user is corrected by looking up its own deletions, so only a few
+ * candidates are compared with an edit distance.
+ */
+class SpellCorrector
+{
+public:
+    enum { MaxDistance = 2, PrefixLength = 7, MinWordLength = 4 };
+
+    void build(const QList<RuleSet> &ruleSets);
+    QString correct(const QString &word) const;
+    QList<QString> correct(const QList<QString> &cmd) const;
+
+private:
+    static int maxDistance(const QString &word);
+    static void addDeletes(const QString &text, int distance, QSet<QString> *deletes);
+    static int editDistance(const QString &a, const QString &b, int max);
+
+    QList<QString> dictionary;
+    QSet<QString> words;
+    QHash<QString, QVector<int>> deletes;
+};
+
+#endif // SPELLCORRECTOR_H
@@ -0,0 +1,84 @@
+#   Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+#	
+#   Copyright (C) <2021>  <SwiftApp>
+#
+#   This program is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   This program is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+# The understanding engine: the plugin loading, the rule matching and the actions.
+# It only uses QtCore, QtXml and QtNetwork, so a tool which does not need the
+# interface can build it with engine/swiftyengine.pro or include this file.
+
+QT += core xml network
+
+# std::pmr is used by the arena of the requests
+CONFIG += c++17
+
+# qmake CONFIG+=alloc_stats counts the heap allocations by stage of the engine and writes those of
+# each request in the debug log, see allocationstats.h. CONFIG+=alloc_counters only counts them.
+alloc_stats: DEFINES += SWIFTY_ALLOC_STATS SWIFTY_ALLOC_LOG
+alloc_counters: DEFINES += SWIFTY_ALLOC_STATS
+
+INCLUDEPATH += $$PWD
+
+HEADERS += \
+    $$PWD/actionqueue.h \
+    $$PWD/allocationstats.h \
+    $$PWD/actiontable.h \
+    $$PWD/batchrunner.h \
+    $$PWD/conversation.h \
+    $$PWD/engine.h \
+    $$PWD/lagmonitor.h \
+    $$PWD/matchcache.h \
+    $$PWD/perfresults.h \
+    $$PWD/perfstats.h \
+    $$PWD/pluginadapter.h \
+    $$PWD/plugininterface.h \
+    $$PWD/pluginrelay.h \
+    $$PWD/reply.h \
+    $$PWD/requestarena.h \
+    $$PWD/rulecache.h \
+    $$PWD/ruleset.h \
+    $$PWD/semanticindex.h \
+    $$PWD/sessionprotocol.h \
+    $$PWD/sessionrecorder.h \
+    $$PWD/sessionreplayer.h \
+    $$PWD/sessionserver.h \
+    $$PWD/slotparser.h \
+    $$PWD/spellcorrector.h \
+    $$PWD/tracer.h
+
+SOURCES += \
+    $$PWD/actionqueue.cpp \
+    $$PWD/allocationstats.cpp \
+    $$PWD/actiontable.cpp \
+    $$PWD/batchrunner.cpp \
+    $$PWD/engine.cpp \
+    $$PWD/lagmonitor.cpp \
+    $$PWD/matchcache.cpp \
+    $$PWD/perfresults.cpp \
+    $$PWD/perfstats.cpp \
+    $$PWD/pluginadapter.cpp \
+    $$PWD/pluginrelay.cpp \
+    $$PWD/reply.cpp \
+    $$PWD/requestarena.cpp \
+    $$PWD/rulecache.cpp \
+    $$PWD/ruleset.cpp \
+    $$PWD/semanticindex.cpp \
+    $$PWD/sessionprotocol.cpp \
+    $$PWD/sessionrecorder.cpp \
+    $$PWD/sessionreplayer.cpp \
+    $$PWD/sessionserver.cpp \
+    $$PWD/slotparser.cpp \
+    $$PWD/spellcorrector.cpp \
+    $$PWD/tracer.cpp
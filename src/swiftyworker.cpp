@@ -17,6 +17,7 @@
 
 #include "swiftyworker.h"
 #include "engine.h"
+#include "perfresults.h"
 
 #include <QtQml>
 #include <QMenu>
@@ -26,9 +27,18 @@
 #include <QMessageBox>
 #include <QDesktopServices>
 
+QString SwiftyWorker::recordFileName;
+int SwiftyWorker::webPrewarm = 0;
+int SwiftyWorker::webViews = 2;
+int SwiftyWorker::webMemoryBudget = 0;
+PerfResults *SwiftyWorker::results = nullptr;
+
 SwiftyWorker::SwiftyWorker(QObject *parent) : QObject(parent)
 {
+    qRegisterMetaType<Reply>();
+
     Engine *engine = new Engine;
+    engineThread.setObjectName("engine");
     engine->moveToThread(&engineThread);
     connect(&engineThread, &QThread::finished, engine, &QObject::deleteLater);
 
@@ -36,6 +46,7 @@ SwiftyWorker::SwiftyWorker(QObject *parent) : QObject(parent)
     connect(this, &SwiftyWorker::textChanged, engine, &Engine::textChanged);
     connect(this, &SwiftyWorker::addBaseProp, engine, &Engine::addBaseProp);
     connect(this, &SwiftyWorker::getAllPlugin, engine, &Engine::getAllPlugin);
+    connect(this, &SwiftyWorker::askStatistics, engine, &Engine::getStatistics);
     connect(this, &SwiftyWorker::signalSendMessageToPlugin, engine, &Engine::sendMessageToPlugin);
     connect(this, &SwiftyWorker::signalRemovePlugin, engine, &Engine::removePlugin);
     connect(this, &SwiftyWorker::signalActuPlugins, engine, &Engine::scanPlugin);
@@ -44,16 +55,22 @@ SwiftyWorker::SwiftyWorker(QObject *parent) : QObject(parent)
     connect(engine, &Engine::addProp, this, &SwiftyWorker::addProp);
     connect(engine, &Engine::removeProp, this, &SwiftyWorker::removeProp);
     connect(engine, &Engine::removeAllProp, this, &SwiftyWorker::removeAllProp);
-    connect(engine, &Engine::showQmlFile, this, &SwiftyWorker::showQmlFile);
+    connect(engine, &Engine::showQmlSource, this, &SwiftyWorker::showQmlSource);
     connect(engine, &Engine::pluginTrouved, this, &SwiftyWorker::pluginTrouved);
+    connect(engine, &Engine::statisticsSended, this, &SwiftyWorker::statisticsReceived);
     connect(engine, &Engine::pluginToQml, this, &SwiftyWorker::messageToQml);
     connect(engine, &Engine::hideWindow, this, &SwiftyWorker::hide);
     connect(engine, &Engine::showWindow, this, &SwiftyWorker::open);
     connect(engine, &Engine::showHomeScreen, this, &SwiftyWorker::showHomeScreen);
     connect(engine, &Engine::previousPage, this, &SwiftyWorker::previousPage);
     connect(engine, &Engine::sendNotify, this, &SwiftyWorker::sendNotify);
+    connect(engine, &Engine::openUrl, this, &SwiftyWorker::openUrl);
+    connect(engine, &Engine::quitRequested, qApp, &QCoreApplication::quit);
 
     engineThread.start();
+    LagMonitor::watch(&engineThread, "engine");
+
+    if (!recordFileName.isEmpty()) recorder = new SessionRecorder(recordFileName);
 
     // Displays the main proposition on the home screen main proposition on the home screen of Swifty Assistant
     emit addBaseProp();
@@ -71,11 +88,57 @@ SwiftyWorker::~SwiftyWorker()
 {
     engineThread.quit();
     engineThread.wait();
+    LagMonitor::unwatch(&engineThread);
+
+    delete recorder;
 }
 
 void SwiftyWorker::declareQML()
 {
     qmlRegisterType<SwiftyWorker>("SwiftyWorker", 1, 0, "Swifty");
+    qmlRegisterUncreatableMetaObject(Reply::staticMetaObject, "SwiftyWorker", 1, 0, "Reply", "Reply is sent by the engine");
+}
+
+/**
+ * Record the keystrokes, the messages and the actions of the user, see SessionRecorder
+ *
+ * @param fileName the recording, set before the interface creates the worker
+ */
+void SwiftyWorker::setRecordFile(const QString &fileName)
+{
+    recordFileName = fileName;
+}
+
+/**
+ * Start the web engine in advance instead of waiting for the first web reply
+ *
+ * @param msecs the delay after the window is shown, 0 to wait for the first web reply
+ */
+void SwiftyWorker::setWebPrewarm(int msecs)
+{
+    webPrewarm = msecs;
+}
+
+/**
+ * Limit the web views kept by the interface, see WebViewPool.qml
+ *
+ * @param maxViews the web views kept to be reused, the least recently used are destroyed first
+ * @param memoryBudget the memory in MiB of the assistant and its web processes above which the hidden views are discarded, 0 for no budget
+ */
+void SwiftyWorker::setWebPool(int maxViews, int memoryBudget)
+{
+    webViews = qMax(1, maxViews);
+    webMemoryBudget = qMax(0, memoryBudget);
+}
+
+/**
+ * Write the cost of the first web view in the results of the startup, see webViewCreated
+ *
+ * @param results the results written when the application quits, they must outlive the interface
+ */
+void SwiftyWorker::setResults(PerfResults *results)
+{
+    SwiftyWorker::results = results;
 }
 
 //===================================================
@@ -90,6 +153,9 @@ void SwiftyWorker::declareQML()
  */
 void SwiftyWorker::messageSended(QString _message)
 {
+    if (recorder) recorder->record(SessionEvent::Message, _message);
+
+    Tracer::hopSent("message");
     emit message(_message);
 }
 
@@ -100,8 +166,14 @@ void SwiftyWorker::messageSended(QString _message)
  */
 void SwiftyWorker::newText(QString text)
 {
-    if (text != "") emit textChanged(text);
-    else emit addBaseProp();
+    if (recorder) recorder->record(SessionEvent::NewText, text);
+    if (text != "") {
+        Tracer::hopSent("newText");
+        emit textChanged(text);
+    }
+    else {
+        emit addBaseProp();
+    }
 }
 
 /**
@@ -112,6 +184,14 @@ void SwiftyWorker::getPluginList()
     emit getAllPlugin();
 }
 
+/**
+ * Sending a message to the engine so that it resends its statistics
+ */
+void SwiftyWorker::getStatistics()
+{
+    emit askStatistics();
+}
+
 /**
  * When a plugin interface is displayed it can use this function to communicate with the plugin
  *
@@ -147,6 +227,9 @@ void SwiftyWorker::actuPlugins()
  */
 void SwiftyWorker::execAction(QString action)
 {
+    if (recorder) recorder->record(SessionEvent::Action, action);
+
+    Tracer::hopSent("action");
     emit executeAction(action);
 }
 
@@ -160,6 +243,64 @@ QString SwiftyWorker::getOs()
     return QSysInfo::productType();
 }
 
+/**
+ * @return the delay before the web engine is started in advance, 0 if it is started by the first web reply
+ */
+int SwiftyWorker::getWebPrewarm()
+{
+    return webPrewarm;
+}
+
+/**
+ * @return the number of web views kept to be reused
+ */
+int SwiftyWorker::getWebViews()
+{
+    return webViews;
+}
+
+/**
+ * @return the memory budget of the web views in MiB, 0 if there is none
+ */
+int SwiftyWorker::getWebMemoryBudget()
+{
+    return webMemoryBudget;
+}
+
+/**
+ * @return the resident memory of the process in bytes, -1 if it is unknown, to log the cost of the web engine
+ */
+qint64 SwiftyWorker::residentMemory()
+{
+    return PerfResults::residentMemory();
+}
+
+/**
+ * @return the resident memory in bytes of the process and of the web engine processes it started, -1 if it is unknown
+ */
+qint64 SwiftyWorker::webMemory()
+{
+    qint64 memory = PerfResults::residentMemory();
+    qint64 children = PerfResults::descendantsMemory();
+    if (memory < 0 || children < 0) return -1;
+
+    return memory + children;
+}
+
+/**
+ * Called by WebViewPool.qml: the first view starts the web engine, its cost is what the startup no longer pays
+ *
+ * @param msecs the time to create the view
+ * @param memory the growth of the resident memory in bytes
+ */
+void SwiftyWorker::webViewCreated(qint64 msecs, qint64 memory)
+{
+    if (results == nullptr || results->contains("web.view.time")) return;
+
+    results->add("web.view.time", msecs, "ms");
+    results->add("web.view.rss", memory / (1024.0*1024.0), "MiB");
+}
+
 void SwiftyWorker::setWindowVisibility(bool visible)
 {
     isWindowShow = visible;
@@ -215,17 +356,14 @@ void SwiftyWorker::createTrayIcon()
 /**
  * When engine send a reponse, display this on the home screen
  *
- * @param _reponse the reponse
- * @param isFin is the last message for the question
- * @param typeMessage if the reponse is a message or an action
- * @param url if the reponse is an web action specify the url of web page
- * @param textUrl if the reponse is an message with action button specify text for button
+ * @param reply the reponse (text, type, web url, action buttons and request id)
  */
-void SwiftyWorker::reponseReceived(
-        QString _reponse, bool isFin, QString typeMessage, QList<QString> url, QList<QString> textUrl
-        )
+void SwiftyWorker::reponseReceived(const Reply &reply)
 {
-    emit reponse(_reponse, isFin, typeMessage, url, textUrl);
+    TRACE_SPAN("reply", "interface");
+    Tracer::hopReceived("reply");
+
+    emit reponse(reply);
 }
 
 /**
@@ -274,13 +412,18 @@ void SwiftyWorker::removeProp(int index)
 }
 
 /**
- * Display a qml file on the Swifty Assistant window
+ * Display the interface of a plugin on the Swifty Assistant window
  *
- * @param qmlUrl url of qml file
+ * @param qml the qml code, compiled only the first time the plugin shows it
+ * @param id the plugin id
  */
-void SwiftyWorker::showQmlFile(QString qmlUrl)
+void SwiftyWorker::showQmlSource(QString qml, QString id)
 {
-    emit showQml(qmlUrl);
+    QQmlEngine *qmlEngine = ::qmlEngine(this);
+    if (qmlEngine == nullptr) return;
+
+    QQmlComponent *component = qmlComponents.component(qmlEngine, id, qml);
+    if (component != nullptr) emit showQml(component);
 }
 
 /**
@@ -293,6 +436,16 @@ void SwiftyWorker::pluginTrouved(QString name)
     emit pluginName(name);
 }
 
+/**
+ * When engine send its statistics
+ *
+ * @param stats the counters and the latencies, see Engine::statistics
+ */
+void SwiftyWorker::statisticsReceived(const QVariantMap &stats)
+{
+    emit statistics(stats);
+}
+
 /**
  * If the plugin whant to send a message to qml file actually showed
  *
@@ -329,10 +482,21 @@ void SwiftyWorker::sendNotify(QString title, QString text, QString action)
 
 void SwiftyWorker::notifyClicked()
 {
+    Tracer::hopSent("action");
     emit executeAction(actionNotify);
     actionNotify.clear();
 }
 
+/**
+ * Open a link requested by the engine in the default browser
+ *
+ * @param url the link
+ */
+void SwiftyWorker::openUrl(const QUrl &url)
+{
+    QDesktopServices::openUrl(url);
+}
+
 void SwiftyWorker::openPluginsFolder()
 {
     QDir pluginsDir(QDir::homePath());
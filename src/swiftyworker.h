@@ -24,9 +24,16 @@
 #include <QThread>
 #include <QDialog>
 #include <QString>
+#include <QUrl>
 #include <QSystemTrayIcon>
+#include <QQmlComponent>
 
 #include "plugininterface.h"
+#include "reply.h"
+#include "sessionrecorder.h"
+#include "qmlcomponentcache.h"
+
+class PerfResults;
 
 class SwiftyWorker : public QObject
 {
@@ -37,29 +44,38 @@ public:
     ~SwiftyWorker();
 
     static void declareQML();
+    static void setRecordFile(const QString &fileName);
+    static void setWebPrewarm(int msecs);
+    static void setWebPool(int maxViews, int memoryBudget);
+    static void setResults(PerfResults *results);
 
     Q_INVOKABLE void messageSended(QString message);
     Q_INVOKABLE void newText(QString text);
     Q_INVOKABLE void getPluginList();
+    Q_INVOKABLE void getStatistics();
     Q_INVOKABLE void sendMessageToPlugin(QString message);
     Q_INVOKABLE void removePlugin(QString id);
     Q_INVOKABLE void actuPlugins();
     Q_INVOKABLE void execAction(QString action);
     Q_INVOKABLE QString getOs();
+    Q_INVOKABLE int getWebPrewarm();
+    Q_INVOKABLE int getWebViews();
+    Q_INVOKABLE int getWebMemoryBudget();
+    Q_INVOKABLE qint64 residentMemory();
+    Q_INVOKABLE qint64 webMemory();
+    Q_INVOKABLE void webViewCreated(qint64 msecs, qint64 memory);
     Q_INVOKABLE void setWindowVisibility(bool visible);
 
 public slots:
-    void reponseReceived(
-            QString reponse, bool isFin, QString typeMessage, QList<QString> url = QList<QString>(),
-            QList<QString> textUrl = QList<QString>()
-            );
+    void reponseReceived(const Reply &reply);
     void open();
     void hide();
     void addProp(QString prop);
     void removeAllProp();
     void removeProp(int index);
-    void showQmlFile(QString qmlUrl);
+    void showQmlSource(QString qml, QString id);
     void pluginTrouved(QString name);
+    void statisticsReceived(const QVariantMap &stats);
     void messageToQml(QString message, QString pluginId);
     void trayIconActivated(QSystemTrayIcon::ActivationReason reason);
     void showHomeScreen();
@@ -67,9 +83,10 @@ public slots:
     void sendNotify(QString title, QString text, QString action);
     void notifyClicked();
     void openPluginsFolder();
+    void openUrl(const QUrl &url);
 
 signals:
-    void reponse(QString text, bool isFin, QString typeMessage, QList<QString> url, QList<QString> textUrl);
+    void reponse(const Reply &reply);
     void message(QString message);
     void textChanged(QString text);
     void showWindow(int x, int y);
@@ -78,9 +95,11 @@ signals:
     void removeAllProposition();
     void removeProposition(int index);
     void addBaseProp();
-    void showQml(QString qmlUrl);
+    void showQml(QQmlComponent *component);
     void getAllPlugin();
     void pluginName(QString name);
+    void askStatistics();
+    void statistics(const QVariantMap &stats);
     void signalSendMessageToPlugin(QString message);
     void pluginSendedMessageToQml(QString message, QString pluginId);
     void signalRemovePlugin(QString id);
@@ -105,6 +124,14 @@ private:
 
     bool isWindowShow = false;
     QString actionNotify;
+
+    static QString recordFileName;
+    static int webPrewarm;
+    static int webViews;
+    static int webMemoryBudget;
+    static PerfResults *results;
+    SessionRecorder *recorder = nullptr;
+    QmlComponentCache qmlComponents;
 };
 
 #endif
@@ -0,0 +1,209 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "tracer.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QThread>
+#include <QSaveFile>
+#include <QMutex>
+#include <QHash>
+#include <QVector>
+
+std::atomic<bool> Tracer::enabled(false);
+
+namespace {
+
+struct TraceEvent
+{
+    const char *name;
+    const char *category;
+    char phase;
+    qint64 start;
+    qint64 duration;
+    int thread;
+    quint64 id;
+    QJsonObject args;
+};
+
+struct TraceData
+{
+    QMutex mutex;
+    QString fileName;
+    QElapsedTimer clock;
+    QVector<TraceEvent> events;
+    QHash<int, QString> threadNames;
+    QHash<QByteArray, quint64> sentHops;
+    QHash<QByteArray, quint64> receivedHops;
+    std::atomic<int> threadCount{0};
+};
+
+TraceData &data()
+{
+    static TraceData traceData;
+    return traceData;
+}
+
+/**
+ * @return the number of the current thread in the trace, its name is remembered the first time
+ */
+int currentThread(TraceData &trace)
+{
+    thread_local int thread = 0;
+
+    if (thread == 0) {
+        thread = ++trace.threadCount;
+
+        QString name = QThread::currentThread()->objectName();
+        if (name.isEmpty()) name = "thread "+QString::number(thread);
+
+        trace.threadNames.insert(thread, name);
+    }
+
+    return thread;
+}
+
+}
+
+/**
+ * Start recording the spans
+ *
+ * @param fileName the trace file, written when the application quits
+ */
+void Tracer::start(const QString &fileName)
+{
+    TraceData &trace = data();
+    QMutexLocker locker(&trace.mutex);
+
+    trace.fileName = fileName;
+    trace.clock.start();
+    enabled = true;
+
+    qAddPostRoutine(Tracer::stop);
+}
+
+/**
+ * Stop recording and write the trace file
+ */
+void Tracer::stop()
+{
+    if (!enabled.exchange(false)) return;
+
+    TraceData &trace = data();
+    QMutexLocker locker(&trace.mutex);
+    QJsonArray events;
+
+    for (auto it = trace.threadNames.constBegin(); it != trace.threadNames.constEnd(); ++it) {
+        QJsonObject event;
+        event.insert("name", "thread_name");
+        event.insert("ph", "M");
+        event.insert("pid", 1);
+        event.insert("tid", it.key());
+        event.insert("args", QJsonObject{{ "name", it.value() }});
+        events.append(event);
+    }
+
+    foreach (const TraceEvent &traceEvent , trace.events) {
+        QJsonObject event;
+        event.insert("name", traceEvent.name);
+        event.insert("cat", traceEvent.category);
+        event.insert("ph", QString(QLatin1Char(traceEvent.phase)));
+        event.insert("pid", 1);
+        event.insert("tid", traceEvent.thread);
+        event.insert("ts", traceEvent.start / 1e3);
+
+        if (traceEvent.phase == 'X') event.insert("dur", traceEvent.duration / 1e3);
+        else event.insert("id", QString::number(traceEvent.id, 16));
+
+        // The end of a hop is bound to the span which receives it
+        if (traceEvent.phase == 'f') event.insert("bp", "e");
+        if (!traceEvent.args.isEmpty()) event.insert("args", traceEvent.args);
+
+        events.append(event);
+    }
+
+    QSaveFile file(trace.fileName);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QJsonDocument(QJsonObject{{ "traceEvents", events }, { "displayTimeUnit", "ms" }}).toJson(QJsonDocument::Compact));
+        file.commit();
+    }
+    else {
+        qWarning("Cannot write the trace in %s", qPrintable(trace.fileName));
+    }
+
+    trace.events.clear();
+}
+
+/**
+ * @return the time since the start of the trace in nanoseconds
+ */
+qint64 Tracer::now()
+{
+    return data().clock.nsecsElapsed();
+}
+
+/**
+ * Add a span, called by TraceSpan
+ *
+ * @param start the value of now() at the beginning of the span
+ * @param duration its duration in nanoseconds
+ * @param args the values displayed with the span, the plugin id for example
+ */
+void Tracer::complete(const char *name, const char *category, qint64 start, qint64 duration, const QJsonObject &args)
+{
+    if (!isEnabled()) return;
+
+    TraceData &trace = data();
+    QMutexLocker locker(&trace.mutex);
+
+    trace.events.append(TraceEvent{ name, category, 'X', start, duration, currentThread(trace), 0, args });
+}
+
+/**
+ * A queued signal is emitted to another thread, drawn as an arrow to the span receiving it
+ *
+ * @param name the signal, each signal is received in the order it is sent
+ */
+void Tracer::hopSent(const char *name)
+{
+    if (isEnabled()) flow(name, 's');
+}
+
+/**
+ * The queued signal sent first by hopSent() is received
+ */
+void Tracer::hopReceived(const char *name)
+{
+    if (isEnabled()) flow(name, 'f');
+}
+
+/**
+ * Add the beginning or the end of an arrow, the n-th end is bound to the n-th beginning
+ */
+void Tracer::flow(const char *name, char phase)
+{
+    TraceData &trace = data();
+    QMutexLocker locker(&trace.mutex);
+
+    quint64 &count = phase == 's' ? trace.sentHops[name] : trace.receivedHops[name];
+    quint64 id = (quint64(qHash(QByteArray(name))) << 32) | ++count;
+
+    trace.events.append(TraceEvent{ name, "hop", phase, now(), 0, currentThread(trace), id, QJsonObject() });
+}
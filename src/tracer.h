@@ -0,0 +1,89 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QString>
+#include <QJsonObject>
+#include <atomic>
+
+#include "lagmonitor.h"
+
+/**
+ * Record spans of the engine and of the interface in a Chrome trace event file,
+ * which can be opened in Perfetto or chrome://tracing.
+ *
+ * The tracing is started by --trace <file> or the SWIFTY_TRACE environment variable
+ * and the file is written when the application quits. When it is not started, a
+ * span only costs the test of isEnabled() and the update of the LagMonitor stage.
+ */
+class Tracer
+{
+public:
+    static inline bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    static void start(const QString &fileName);
+    static void stop();
+
+    static qint64 now();
+    static void complete(const char *name, const char *category, qint64 start, qint64 duration, const QJsonObject &args);
+    static void hopSent(const char *name);
+    static void hopReceived(const char *name);
+
+private:
+    static void flow(const char *name, char phase);
+
+    static std::atomic<bool> enabled;
+};
+
+/**
+ * A span from its creation to the end of the scope, see TRACE_SPAN.
+ * It is also the active stage of the thread reported by LagMonitor.
+ */
+class TraceSpan
+{
+public:
+    inline TraceSpan(const char *name, const char *category) :
+        name(name), category(category), previousStage(LagMonitor::enterStage(name)),
+        start(Tracer::isEnabled() ? Tracer::now() : -1) {}
+
+    inline ~TraceSpan()
+    {
+        if (start >= 0) Tracer::complete(name, category, start, Tracer::now()-start, args);
+        LagMonitor::leaveStage(previousStage);
+    }
+
+    inline void addArg(const char *key, const QString &value)
+    {
+        if (start >= 0) args.insert(QLatin1String(key), value);
+    }
+
+private:
+    const char *name;
+    const char *category;
+    const char *previousStage;
+    qint64 start;
+    QJsonObject args;
+};
+
+#define TRACE_SPAN(name, category) TraceSpan traceSpan(name, category)
+
+// The value is not computed when the tracing is disabled
+#define TRACE_ARG(key, value) if (Tracer::isEnabled()) traceSpan.addArg(key, value)
+
+#endif // TRACER_H
@@ -0,0 +1,433 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include <QtTest>
+#include <QTemporaryDir>
+
+#include "engine.h"
+
+/**
+ * A plugin made of the xml given by the test, which records the actions it receives
+ */
+class TestPlugin : public QObject, public PluginInterfaceV2
+{
+    Q_OBJECT
+    Q_INTERFACES(PluginInterfaceV2)
+
+public:
+    explicit TestPlugin(const QString &xml, const QList<QString> &hostActions = QList<QString>())
+        : xml(xml), paths(hostActions) {}
+
+    QString getDataXml() const override { return xml; }
+    QString pluginId() const override { return "fr.swifty.test"; }
+    void execAction(const QList<QString> &cmd) override { actions.append(cmd.join(" ")); }
+    QList<QString> getCommande() const override { return QList<QString>(); }
+    QObject* getObject() override { return this; }
+    QList<QString> hostActions() const override { return paths; }
+
+    void execSlotAction(const QList<QString> &cmd, const QVariantMap &values) override
+    {
+        slotValues = values;
+        execAction(cmd);
+    }
+
+    QList<QString> actions;
+    QVariantMap slotValues;
+
+signals:
+    void sendMessage(QString reply, bool isFin, QString typeMessage, QString id, QList<QString> url = QList<QString>(), QList<QString> textUrl = QList<QString>());
+    void sendMessageToQml(QString message);
+    void showQml(QString qml, QString id);
+    void execAction(QString action);
+
+public slots:
+    void messageReceived(const QString &message, const QString &pluginId) override
+    {
+        Q_UNUSED(message)
+        Q_UNUSED(pluginId)
+    }
+
+private:
+    QString xml;
+    QList<QString> paths;
+};
+
+/**
+ * Record the text of the replies sent by an engine
+ */
+static void recordReplies(Engine *engine, QList<QString> *replies)
+{
+    QObject::connect(engine, &Engine::reponseSended, [replies](const Reply &reply) { replies->append(reply.text()); });
+}
+
+/**
+ * An item of the test plugin
+ *
+ * @param word the word the command must contain
+ * @param content the elements which follow the <Keywords>
+ */
+static QString item(const QString &word, const QString &content)
+{
+    return "<Item><Keywords minWord=\"1\" maxWord=\"6\"><Words><word>"+word+"</word></Words></Keywords>"+content+"</Item>";
+}
+
+/**
+ * Compile one item and read its <Var> and <Slot> elements in a command
+ *
+ * @param content the elements of the item
+ * @param command the words of the command, separated by a space
+ */
+static QStringList extractVars(const QString &content, const QString &command, RuleItem::VarMode mode = RuleItem::LastKeyword)
+{
+    RuleSet rules = RuleSet::compile("fr.swifty.test", "<Swifty><Item>"+content+"</Item></Swifty>", QList<QString>(), QByteArray());
+    QList<QString> cmd = command.split(' ');
+
+    return QStringList(rules.items.first().extractVars(cmd, rules.tokenIds(cmd), mode));
+}
+
+static const char *mediaXml =
+        "<Swifty>"
+        "<Item id=\"next\"><Keywords minWord=\"1\" maxWord=\"4\"><Words><word>suivante</word></Words></Keywords>"
+        "<Reply><rep>Chanson suivante</rep></Reply><Actions><action>media next</action></Actions></Item>"
+        "<Item id=\"pause\"><Keywords minWord=\"1\" maxWord=\"4\"><Words><word>pause</word></Words></Keywords>"
+        "<Reply><rep>Pause</rep></Reply><Actions><action>media pause</action></Actions></Item>"
+        "</Swifty>";
+
+/**
+ * Tests of the engine with plugins defined in the test
+ */
+class EngineTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void hostActionKeepsPluginActions();
+    void hostActionReachesPlugin();
+    void elementsInXmlOrder();
+    void engineActionBeforeReply();
+    void batchTimedOnce();
+    void varMax_data();
+    void varMax();
+    void varFirstKeyword();
+    void emptyVarShiftsIndexes();
+    void typedSlots_data();
+    void typedSlots();
+    void slotValuesReachPlugin();
+    void lateReplyGoesToCaller();
+    void cachedRulesRoundTrip();
+
+private:
+    QTemporaryDir home;
+};
+
+void EngineTest::initTestCase()
+{
+    QVERIFY(home.isValid());
+
+    // The engine loads the plugins of ~/SwiftyPlugins and writes its settings in the home folder
+    qputenv("HOME", home.path().toLocal8Bit());
+}
+
+/**
+ * "media pause" registered for all the plugins must not take the other "media" actions of the plugin
+ */
+void EngineTest::hostActionKeepsPluginActions()
+{
+    Engine engine;
+    TestPlugin plugin(mediaXml, QList<QString>() << "media pause");
+    engine.addPlugin(&plugin);
+
+    engine.messageReceived("suivante");
+
+    QTRY_COMPARE(plugin.actions, QList<QString>() << "media next");
+}
+
+void EngineTest::hostActionReachesPlugin()
+{
+    Engine engine;
+    TestPlugin plugin(mediaXml, QList<QString>() << "media pause");
+    engine.addPlugin(&plugin);
+
+    engine.messageReceived("pause");
+
+    QTRY_COMPARE(plugin.actions, QList<QString>() << "media pause");
+}
+
+/**
+ * The elements of an item are executed in the order of the xml, a <Reply> only reads the <Var> before it
+ */
+void EngineTest::elementsInXmlOrder()
+{
+    Engine engine;
+    TestPlugin plugin("<Swifty>"+item("appelle", "<Reply><rep>Avant ?1</rep></Reply>"
+                                      "<Var max=\"1\"><word>moi</word></Var>"
+                                      "<Reply><rep>Après ?1</rep></Reply>")+"</Swifty>");
+    engine.addPlugin(&plugin);
+    QList<QString> replies;
+    recordReplies(&engine, &replies);
+
+    engine.messageReceived("appelle moi paul");
+
+    QCOMPARE(replies, QList<QString>() << "Avant " << "Après paul");
+}
+
+/**
+ * "settings name" is executed before the next <Reply> of the item, which reads the new name
+ */
+void EngineTest::engineActionBeforeReply()
+{
+    Engine engine;
+    TestPlugin plugin("<Swifty>"+item("appelle", "<Var max=\"1\"><word>moi</word></Var>"
+                                      "<Actions><action>settings name ?1</action></Actions>"
+                                      "<Reply><rep>Enchanté ?name</rep></Reply>")+"</Swifty>");
+    engine.addPlugin(&plugin);
+    QList<QString> replies;
+    recordReplies(&engine, &replies);
+
+    engine.messageReceived("appelle moi paul");
+
+    QCOMPARE(replies, QList<QString>() << "Enchanté paul");
+    QVERIFY(plugin.actions.isEmpty());
+}
+
+/**
+ * A batch is one call, its time is not recorded under the verbs of its actions
+ */
+void EngineTest::batchTimedOnce()
+{
+    Engine engine;
+    TestPlugin plugin("<Swifty>"+item("joue", "<Reply><rep>Ok</rep></Reply><Actions><action>media play</action><action>media volume 5</action></Actions>")
+                      +item("stop", "<Reply><rep>Ok</rep></Reply><Actions><action>media stop</action></Actions>")+"</Swifty>");
+    engine.addPlugin(&plugin);
+
+    engine.messageReceived("joue");
+    QTRY_COMPARE(plugin.actions.length(), 2);
+    engine.messageReceived("stop");
+    QTRY_COMPARE(plugin.actions.length(), 3);
+
+    QCOMPARE(engine.batchTimings().value("fr.swifty.test").count, quint64(1));
+    QCOMPARE(engine.batchTimings().value("fr.swifty.test").actions, quint64(2));
+    QCOMPARE(engine.actionTimings().value("fr.swifty.test media").count, quint64(1));
+}
+
+/**
+ * A <Var> takes at most max words after the keyword found the furthest in the command, as before the slot table
+ */
+void EngineTest::varMax_data()
+{
+    QTest::addColumn<QString>("content");
+    QTest::addColumn<QString>("command");
+    QTest::addColumn<QStringList>("vars");
+
+    QTest::newRow("max") << "<Var max=\"2\"><word>cherche</word></Var>" << "cherche un chat noir" << QStringList {"un chat"};
+    QTest::newRow("no max") << "<Var><word>ecris</word></Var>" << "ecris bonjour a tous" << QStringList {"bonjour a tous"};
+    QTest::newRow("furthest keyword") << "<Var max=\"3\"><word>de</word><word>sur</word></Var>" << "parle de la vie sur mars" << QStringList {"mars"};
+    QTest::newRow("last occurrence") << "<Var max=\"1\"><word>de</word></Var>" << "de paris de lyon" << QStringList {"lyon"};
+    QTest::newRow("keyword at the end") << "<Var max=\"1\"><word>cherche</word></Var>" << "je cherche" << QStringList {""};
+    QTest::newRow("no keyword") << "<Var max=\"1\"><word>cherche</word></Var>" << "trouve un chat" << QStringList {""};
+    QTest::newRow("two vars") << "<Var max=\"1\"><word>de</word></Var><Var max=\"1\"><word>a</word></Var>" << "va de paris a lyon" << QStringList {"paris", "lyon"};
+}
+
+void EngineTest::varMax()
+{
+    QFETCH(QString, content);
+    QFETCH(QString, command);
+    QFETCH(QStringList, vars);
+
+    QCOMPARE(extractVars(content, command), vars);
+}
+
+/**
+ * In a sub-item the first keyword of the list found in the command is used
+ */
+void EngineTest::varFirstKeyword()
+{
+    const QString content = "<Var max=\"1\"><word>a</word><word>de</word></Var>";
+
+    QCOMPARE(extractVars(content, "a paris de lyon", RuleItem::FirstKeyword), QStringList {"paris"});
+    QCOMPARE(extractVars(content, "a paris de lyon", RuleItem::LastKeyword), QStringList {"lyon"});
+}
+
+/**
+ * ?1, ?2... are the filled elements, an empty <Var> gives its index to the next one
+ */
+void EngineTest::emptyVarShiftsIndexes()
+{
+    Engine engine;
+    TestPlugin plugin("<Swifty>"+item("va", "<Var max=\"1\"><word>de</word></Var><Var max=\"1\"><word>a</word></Var>"
+                                      "<Reply><rep>[?1] [?2]</rep></Reply>")+"</Swifty>");
+    engine.addPlugin(&plugin);
+    QList<QString> replies;
+    recordReplies(&engine, &replies);
+
+    engine.messageReceived("va de paris a lyon");
+    engine.messageReceived("va a lyon");
+
+    QCOMPARE(replies, QList<QString>() << "[paris] [lyon]" << "[lyon] []");
+}
+
+void EngineTest::typedSlots_data()
+{
+    QTest::addColumn<QString>("content");
+    QTest::addColumn<QString>("command");
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<QVariant>("value");
+
+    const QString number = "<Slot name=\"n\" type=\"number\"><word>mets</word></Slot>";
+    const QString duration = "<Slot name=\"d\" type=\"duration\"><word>dans</word></Slot>";
+    const QString dateTime = "<Slot name=\"t\" type=\"datetime\"><word>pour</word></Slot>";
+    const QString choice = "<Slot name=\"piece\" type=\"enum\"><value>salon</value><value>cuisine</value></Slot>";
+
+    QTest::newRow("number digits") << number << "mets 12 degres" << "12" << QVariant(qint64(12));
+    QTest::newRow("number decimal") << number << "mets 3.5 degres" << "3.5" << QVariant(3.5);
+    QTest::newRow("number words") << number << "mets vingt et un degres" << "vingt et un" << QVariant(qint64(21));
+    QTest::newRow("number without keyword") << "<Slot name=\"n\" type=\"number\"/>" << "il fait douze degres" << "douze" << QVariant(qint64(12));
+    QTest::newRow("duration words") << duration << "rappelle moi dans cinq minutes" << "cinq minutes" << QVariant(qint64(300));
+    QTest::newRow("duration compact") << duration << "rappelle moi dans 1h30" << "1h30" << QVariant(qint64(5400));
+    QTest::newRow("duration half") << duration << "dans une heure et demie" << "une heure et demie" << QVariant(qint64(5400));
+    QTest::newRow("no duration") << duration << "rappelle moi dans la cuisine" << "" << QVariant();
+    QTest::newRow("datetime tomorrow") << dateTime << "un rappel pour demain a 14h30" << "demain a 14h30"
+                                       << QVariant(QDateTime(QDate(2026, 10, 20), QTime(14, 30)));
+    QTest::newRow("datetime week day") << dateTime << "un rappel pour lundi" << "lundi"
+                                       << QVariant(QDateTime(QDate(2026, 10, 26), QTime(0, 0)));
+    QTest::newRow("datetime hour passed") << dateTime << "un rappel pour 9 heures" << "9 heures"
+                                          << QVariant(QDateTime(QDate(2026, 10, 20), QTime(9, 0)));
+    QTest::newRow("enum") << choice << "allume la cuisine" << "cuisine" << QVariant("cuisine");
+    QTest::newRow("enum unknown") << choice << "allume le garage" << "" << QVariant();
+}
+
+/**
+ * The typed <Slot> elements, the relative dates are computed from monday 19 october 2026 at 10:00
+ */
+void EngineTest::typedSlots()
+{
+    QFETCH(QString, content);
+    QFETCH(QString, command);
+    QFETCH(QString, text);
+    QFETCH(QVariant, value);
+
+    QStringList vars = extractVars(content, command);
+    QCOMPARE(vars, QStringList {text});
+
+    if (text.isEmpty()) return;
+
+    RuleSet rules = RuleSet::compile("fr.swifty.test", "<Swifty><Item>"+content+"</Item></Swifty>", QList<QString>(), QByteArray());
+    const QDateTime now(QDate(2026, 10, 19), QTime(10, 0));
+
+    QCOMPARE(SlotParser::value(rules.items.first().vars.first().type, text, now), value);
+}
+
+/**
+ * The values of the <Slot> elements are given to the plugin and to the replies by name
+ */
+void EngineTest::slotValuesReachPlugin()
+{
+    Engine engine;
+    TestPlugin plugin("<Swifty>"+item("rappelle", "<Slot name=\"duree\" type=\"duration\"><word>dans</word></Slot>"
+                                      "<Reply><rep>Rappel dans ?{duree} (?{duree.value} s)</rep></Reply>"
+                                      "<Actions><action>timer start</action></Actions>")+"</Swifty>");
+    engine.addPlugin(&plugin);
+    QList<QString> replies;
+    recordReplies(&engine, &replies);
+
+    engine.messageReceived("rappelle moi dans cinq minutes");
+
+    QCOMPARE(replies, QList<QString>() << "Rappel dans cinq minutes (300 s)");
+    QTRY_COMPARE(plugin.actions, QList<QString>() << "timer start");
+    QCOMPARE(plugin.slotValues.value("duree"), QVariant(qint64(300)));
+}
+
+/**
+ * In the daemon mode, a reply sent by a plugin after the request goes to the session which called it
+ */
+void EngineTest::lateReplyGoesToCaller()
+{
+    TestPlugin plugin(mediaXml);
+    Engine source;
+    source.addPlugin(&plugin);
+    source.setWorkerMode();
+    Engine worker(&source);
+    Engine other(&source);
+
+    QList<QString> replies;
+    QList<QString> otherReplies;
+    QList<QString> sessions;
+    recordReplies(&worker, &replies);
+    recordReplies(&other, &otherReplies);
+    recordReplies(&source, &otherReplies);
+
+    Conversation kitchen = worker.newConversation();
+    kitchen.session = "1/kitchen";
+
+    connect(&worker, &Engine::pluginSignalAfterRequest, this, [&](const QString &session, const std::function<void()> &slot) {
+        sessions.append(session);
+        worker.setConversation(&kitchen);
+        slot();
+        worker.setConversation(nullptr);
+    });
+    connect(&other, &Engine::pluginSignalAfterRequest, this, [&](const QString &session) { sessions.append("other "+session); });
+
+    worker.setConversation(&kitchen);
+    worker.messageReceived("suivante");
+    worker.runActions();
+    worker.setConversation(nullptr);
+
+    QCOMPARE(plugin.actions, QList<QString>() << "media next");
+
+    emit plugin.sendMessage("Chanson chargée", true, "message", "fr.swifty.test");
+
+    QTRY_COMPARE(sessions, QList<QString>() << "1/kitchen");
+    QCOMPARE(replies, QList<QString>() << "Chanson suivante" << "Chanson chargée");
+    QVERIFY(otherReplies.isEmpty());
+}
+
+/**
+ * The rules read from the cache keep the order of the elements, a step outside of its item is refused
+ */
+void EngineTest::cachedRulesRoundTrip()
+{
+    RuleSet rules = RuleSet::compile("fr.swifty.test", "<Swifty>"+item("appelle", "<Reply><rep>Avant</rep></Reply>"
+                                                                       "<Var max=\"1\"><word>moi</word></Var>"
+                                                                       "<Actions><action>media play</action></Actions>")+"</Swifty>",
+                                     QList<QString>(), "key");
+    QByteArray blob;
+    QDataStream out(&blob, QIODevice::WriteOnly);
+    out << rules;
+
+    RuleSet read;
+    QDataStream in(blob);
+    in >> read;
+
+    QCOMPARE(in.status(), QDataStream::Ok);
+    QCOMPARE(read.items.first().steps.length(), 3);
+    QCOMPARE(read.items.first().steps.at(1).kind, RuleStep::Var);
+
+    rules.items.first().steps[2].index = 1;
+    QByteArray damaged;
+    QDataStream damagedOut(&damaged, QIODevice::WriteOnly);
+    damagedOut << rules;
+
+    QDataStream damagedIn(damaged);
+    damagedIn >> read;
+
+    QCOMPARE(damagedIn.status(), QDataStream::ReadCorruptData);
+}
+
+QTEST_GUILESS_MAIN(EngineTest)
+
+#include "enginetest.moc"
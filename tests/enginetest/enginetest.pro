@@ -0,0 +1,31 @@
+#   Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+#	
+#   Copyright (C) <2021>  <SwiftApp>
+#
+#   This program is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   This program is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+# Tests of the engine: qmake tests/enginetest/enginetest.pro && make && ./enginetest
+
+QT += testlib
+QT -= gui
+
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+TARGET = enginetest
+
+include(../../src/swiftyengine.pri)
+
+SOURCES += \
+    enginetest.cpp
@@ -0,0 +1,105 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "generatedplugin.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDebug>
+#include <QTextStream>
+#include <QCoreApplication>
+
+#ifdef Q_OS_UNIX
+#include <dlfcn.h>
+#endif
+
+/**
+ * Read the xml and the propositions written next to the library
+ */
+GeneratedPlugin::GeneratedPlugin()
+{
+    QFileInfo library(libraryPath());
+    QString base = library.absolutePath()+"/"+library.completeBaseName();
+
+    id = "fr.swifty.generated."+library.completeBaseName();
+
+    QFile xmlFile(base+".xml");
+    if (xmlFile.open(QIODevice::ReadOnly)) xml = QString::fromUtf8(xmlFile.readAll());
+    else qWarning() << "GeneratedPlugin: unable to read" << xmlFile.fileName();
+
+    QFile commandsFile(base+".commands");
+    if (commandsFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QTextStream stream(&commandsFile);
+        stream.setCodec("UTF-8");
+
+        while (!stream.atEnd()) {
+            QString line = stream.readLine();
+            if (!line.isEmpty()) commands.append(line);
+        }
+    }
+}
+
+QString GeneratedPlugin::getDataXml()
+{
+    return xml;
+}
+
+QString GeneratedPlugin::pluginId()
+{
+    return id;
+}
+
+void GeneratedPlugin::execAction(QList<QString> cmd)
+{
+    Q_UNUSED(cmd)
+}
+
+QList<QString> GeneratedPlugin::getCommande()
+{
+    return commands;
+}
+
+QObject* GeneratedPlugin::getObject()
+{
+    return this;
+}
+
+void GeneratedPlugin::messageReceived(QString message, QString pluginId)
+{
+    Q_UNUSED(message)
+    Q_UNUSED(pluginId)
+}
+
+/**
+ * @return the path of the copy of the library containing this plugin
+ */
+QString GeneratedPlugin::libraryPath()
+{
+#ifdef Q_OS_UNIX
+    static const char marker = 0;
+    Dl_info info;
+    if (dladdr(&marker, &info) && info.dli_fname)
+        return QFile::decodeName(info.dli_fname);
+#endif
+
+    // Each copy is loaded once, the copies are loaded in the order of their names
+    int index = qApp->property("generatedPluginCount").toInt();
+    qApp->setProperty("generatedPluginCount", index+1);
+
+    return QDir::homePath()+"/SwiftyPlugins/synthetic_"+QString::number(index)+".sw";
+}
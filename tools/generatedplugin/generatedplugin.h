@@ -0,0 +1,65 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#ifndef GENERATEDPLUGIN_H
+#define GENERATEDPLUGIN_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+
+#include "plugininterface.h"
+
+/**
+ * A plugin serving the xml of a file, used to load many generated plugins in the assistant.
+ *
+ * syntheticgen copies the library to <name>.sw next to <name>.xml and
+ * <name>.commands (one proposition per line), each copy is a different plugin.
+ */
+class GeneratedPlugin : public QObject, public PluginInterface
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID PluginInterface_iid)
+    Q_INTERFACES(PluginInterface)
+
+public:
+    GeneratedPlugin();
+
+    QString getDataXml() override;
+    QString pluginId() override;
+    void execAction(QList<QString> cmd) override;
+    QList<QString> getCommande() override;
+    QObject* getObject() override;
+
+signals:
+    void sendMessage(QString reply, bool isFin, QString typeMessage, QString id, QList<QString> url = QList<QString>(), QList<QString> textUrl = QList<QString>());
+    void sendMessageToQml(QString message);
+    void showQml(QString qml, QString id);
+    void execAction(QString action);
+
+public slots:
+    void messageReceived(QString message, QString pluginId) override;
+
+private:
+    static QString libraryPath();
+
+    QString id;
+    QString xml;
+    QList<QString> commands;
+};
+
+#endif // GENERATEDPLUGIN_H
@@ -0,0 +1,34 @@
+#   Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+#	
+#   Copyright (C) <2021>  <SwiftApp>
+#
+#   This program is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   This program is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+# Generic plugin serving the xml written by syntheticgen, see tools/syntheticgen/syntheticgen.pro
+
+TEMPLATE = lib
+CONFIG += plugin
+QT = core
+
+TARGET = generatedplugin
+
+INCLUDEPATH += ../../src
+
+unix: LIBS += -ldl
+
+HEADERS += \
+    generatedplugin.h
+
+SOURCES += \
+    generatedplugin.cpp
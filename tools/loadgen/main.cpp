@@ -0,0 +1,271 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QLocalSocket>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <QFile>
+#include <QVector>
+#include <QMap>
+
+#include <algorithm>
+
+#include "sessionprotocol.h"
+#include "perfresults.h"
+
+/**
+ * The latencies of the responses by request type, in nanoseconds
+ */
+struct Measures
+{
+    QMap<QString, QVector<qint64>> latencies;
+    int errors = 0;
+    int sessions = 0;
+    int finished = 0;
+};
+
+/**
+ * A user of the assistant with its own connection: each request is sent when the response
+ * of the previous one is received. The user types each message, one "text" request per
+ * character, then sends it.
+ */
+class LoadSession
+{
+public:
+    LoadSession(int index, const QList<QString> &messages, bool isTyping, const QElapsedTimer &clock, Measures *measures);
+    ~LoadSession();
+
+    void start(const QString &server);
+
+private:
+    void sendNext();
+    void readResponses();
+    void finish();
+
+    QLocalSocket *socket;
+    QString session;
+    QList<QPair<QString, QString>> requests;
+    const QElapsedTimer &clock;
+    Measures *measures;
+    QByteArray buffer;
+    int next = 0;
+    qint64 sentAt = 0;
+    bool isFinished = false;
+};
+
+LoadSession::LoadSession(int index, const QList<QString> &messages, bool isTyping, const QElapsedTimer &clock, Measures *measures)
+    : socket(new QLocalSocket), session("load "+QString::number(index)), clock(clock), measures(measures)
+{
+    foreach (QString message , messages) {
+        if (isTyping) {
+            for (int i = 1; i <= message.length(); i++) requests.append(qMakePair(QString("text"), message.left(i)));
+        }
+
+        requests.append(qMakePair(QString("message"), message));
+    }
+
+    QObject::connect(socket, &QLocalSocket::connected, socket, [this]() { sendNext(); });
+    QObject::connect(socket, &QLocalSocket::readyRead, socket, [this]() { readResponses(); });
+    QObject::connect(socket, &QLocalSocket::errorOccurred, socket, [this]() {
+        if (isFinished) return;
+
+        qCritical("%s: %s", qPrintable(session), qPrintable(socket->errorString()));
+        measures->errors++;
+        finish();
+    });
+}
+
+LoadSession::~LoadSession()
+{
+    delete socket;
+}
+
+void LoadSession::start(const QString &server)
+{
+    socket->connectToServer(server);
+}
+
+void LoadSession::sendNext()
+{
+    if (next >= requests.length()) {
+        finish();
+        return;
+    }
+
+    QJsonObject request;
+    request.insert("id", next);
+    request.insert("session", session);
+    request.insert("type", requests.at(next).first);
+    request.insert("text", requests.at(next).second);
+
+    sentAt = clock.nsecsElapsed();
+    socket->write(SessionProtocol::encode(request));
+}
+
+void LoadSession::readResponses()
+{
+    buffer.append(socket->readAll());
+
+    QJsonObject response;
+    SessionProtocol::Result result = SessionProtocol::Incomplete;
+
+    while (!isFinished && (result = SessionProtocol::decode(buffer, &response)) == SessionProtocol::Complete) {
+        // The replies sent later by the plugins are not the response of the request
+        if (!response.contains("id")) continue;
+
+        if (response.contains("error")) {
+            qWarning("%s: %s", qPrintable(session), qPrintable(response.value("error").toString()));
+            measures->errors++;
+        }
+
+        measures->latencies[requests.at(next).first].append(clock.nsecsElapsed() - sentAt);
+        next++;
+        sendNext();
+    }
+
+    if (!isFinished && result == SessionProtocol::Invalid) {
+        qCritical("%s: invalid response", qPrintable(session));
+        measures->errors++;
+        finish();
+    }
+}
+
+void LoadSession::finish()
+{
+    if (isFinished) return;
+
+    isFinished = true;
+    socket->disconnectFromServer();
+
+    if (++measures->finished == measures->sessions) QCoreApplication::quit();
+}
+
+/**
+ * @return the utterances of a file, one per line, or a few commands of the default plugins
+ */
+static QList<QString> readUtterances(const QString &fileName, bool *isOk)
+{
+    *isOk = true;
+
+    if (fileName.isEmpty()) {
+        return QList<QString>() << "bonjour" << "quelle heure est-il" << "quel temps fait-il demain"
+                                << "mets la musique" << "allume la lumière du salon" << "comment tu t'appelles";
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qCritical("Cannot open %s", qPrintable(fileName));
+        *isOk = false;
+        return QList<QString>();
+    }
+
+    QList<QString> utterances;
+    foreach (QByteArray line , file.readAll().split('\n')) {
+        QString utterance = QString::fromUtf8(line).trimmed();
+        if (!utterance.isEmpty()) utterances.append(utterance);
+    }
+
+    return utterances;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("loadgen");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Simulate concurrent sessions on the daemon mode of Swifty Assistant (--daemon <name>) "
+                                     "and report the throughput and the latencies");
+    parser.addHelpOption();
+    parser.addOptions({
+        { "server", "Name of the local socket of the daemon, swifty by default.", "name", "swifty" },
+        { "sessions", "Number of concurrent sessions, 10 by default.", "n", "10" },
+        { "messages", "Number of messages sent by each session, 20 by default.", "n", "20" },
+        { "utterances", "File of the messages, one per line, like synthetic_utterances.txt of syntheticgen.", "file" },
+        { "no-typing", "Send the messages without the keystrokes before them." },
+        { "results", "Write the results in <file>, for tools/perfbaseline.", "file" },
+        { "seed", "Seed of the choice of the messages, 1 by default.", "n", "1" }
+    });
+    parser.process(app);
+
+    bool isOk;
+    const QList<QString> utterances = readUtterances(parser.value("utterances"), &isOk);
+    if (!isOk) return 1;
+    if (utterances.isEmpty()) {
+        qCritical("No utterance");
+        return 1;
+    }
+
+    QRandomGenerator generator(parser.value("seed").toUInt());
+    QElapsedTimer clock;
+    Measures measures;
+    QList<LoadSession *> sessions;
+    const int count = parser.value("sessions").toInt();
+    measures.sessions = count;
+
+    for (int i = 0; i < count; i++) {
+        QList<QString> messages;
+        for (int m = 0; m < parser.value("messages").toInt(); m++) messages.append(utterances.at(generator.bounded(utterances.length())));
+
+        sessions.append(new LoadSession(i, messages, !parser.isSet("no-typing"), clock, &measures));
+    }
+
+    clock.start();
+    foreach (LoadSession *session , sessions) session->start(parser.value("server"));
+
+    // The sessions which cannot connect may finish before the event loop starts
+    if (measures.finished < count) app.exec();
+
+    const double seconds = clock.nsecsElapsed() / 1e9;
+    qDeleteAll(sessions);
+
+    PerfResults results;
+    QTextStream out(stdout);
+    int total = 0;
+
+    for (auto it = measures.latencies.begin(); it != measures.latencies.end(); ++it) {
+        QVector<qint64> &latencies = it.value();
+        std::sort(latencies.begin(), latencies.end());
+        total += latencies.length();
+
+        auto ms = [&latencies](int p) { return PerfResults::percentile(latencies, p) / 1e6; };
+
+        out << it.key() << " (ms): " << latencies.length()
+            << ", p50 " << QString::number(ms(50), 'f', 3)
+            << ", p90 " << QString::number(ms(90), 'f', 3)
+            << ", p99 " << QString::number(ms(99), 'f', 3)
+            << ", max " << QString::number(ms(100), 'f', 3) << "\n";
+
+        results.add("loadgen."+it.key()+".p50", ms(50), "ms");
+        results.add("loadgen."+it.key()+".p90", ms(90), "ms");
+        results.add("loadgen."+it.key()+".p99", ms(99), "ms");
+        results.add("loadgen."+it.key()+".max", ms(100), "ms");
+    }
+
+    out << count << " sessions, " << total << " requests in " << QString::number(seconds, 'f', 3) << " s: "
+        << QString::number(total / seconds, 'f', 1) << " requests/s, " << measures.errors << " errors" << Qt::endl;
+
+    if (total > 0) results.add("loadgen.request_time", seconds * 1e3 / total, "ms");
+    results.add("loadgen.errors", measures.errors, "events");
+
+    if (parser.isSet("results") && !results.save(parser.value("results"))) return 1;
+
+    return measures.errors > 0 ? 1 : 0;
+}
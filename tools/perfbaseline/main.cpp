@@ -0,0 +1,221 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+#include <QVector>
+
+#include <algorithm>
+#include <cmath>
+
+#include "perfresults.h"
+
+/**
+ * Exit codes of the tool, a gate fails on anything else than Success
+ */
+enum ExitCode { Success = 0, Regression = 1, Error = 2 };
+
+static double median(QVector<double> values)
+{
+    if (values.isEmpty()) return 0;
+
+    std::sort(values.begin(), values.end());
+    const int middle = values.length() / 2;
+
+    return values.length() % 2 ? values.at(middle) : (values.at(middle-1) + values.at(middle)) / 2;
+}
+
+/**
+ * Robust estimation of the standard deviation: 1.4826 times the median absolute deviation.
+ * A single slow run does not widen the threshold as a standard deviation would.
+ *
+ * @return 0 with less than 3 values, the noise is then unknown
+ */
+static double noise(const QVector<double> &values)
+{
+    if (values.length() < 3) return 0;
+
+    const double center = median(values);
+    QVector<double> deviations;
+    deviations.reserve(values.length());
+
+    for (double value : values) deviations.append(std::abs(value - center));
+
+    return 1.4826 * median(deviations);
+}
+
+/**
+ * The smallest change considered for a unit, under the resolution of the measures
+ */
+static double minimumChange(const QString &unit)
+{
+    if (unit == "ns") return 20;
+    if (unit == "ms") return 0.02;
+    if (unit == "allocs") return 0.5;
+    if (unit == "bytes") return 64;
+    if (unit == "events") return 1;
+
+    return 0;
+}
+
+/**
+ * Read and merge result files
+ *
+ * @return false if one of them cannot be read
+ */
+static bool loadAll(const QList<QString> &fileNames, PerfResults &results)
+{
+    foreach (QString fileName , fileNames) {
+        PerfResults file;
+        if (!PerfResults::load(fileName, file)) return false;
+
+        results.merge(file);
+    }
+
+    return true;
+}
+
+/**
+ * perfbaseline save <baseline> <results>...
+ *
+ * Write the values of the results as a baseline, or add them to the baseline with --append
+ */
+static int save(const QCommandLineParser &parser, const QList<QString> &arguments)
+{
+    const QString baselineFile = arguments.at(0);
+    PerfResults baseline;
+
+    if (parser.isSet("append") && !PerfResults::load(baselineFile, baseline)) return Error;
+    if (!loadAll(arguments.mid(1), baseline)) return Error;
+
+    if (baseline.isEmpty()) {
+        qCritical("No result to save");
+        return Error;
+    }
+
+    if (parser.isSet("label")) baseline.setLabel(parser.value("label"));
+    if (!baseline.save(baselineFile)) return Error;
+
+    QTextStream(stdout) << baseline.names().length() << " metrics saved to " << baselineFile << Qt::endl;
+
+    return Success;
+}
+
+/**
+ * perfbaseline compare <baseline> <results>...
+ *
+ * The median of the new values is compared to the median of the baseline. A metric regresses
+ * when it grows by more than the largest of: --threshold percents of the baseline, --noise
+ * times the noise of the baseline or of the new values, and the minimum change of its unit.
+ */
+static int compare(const QCommandLineParser &parser, const QList<QString> &arguments)
+{
+    PerfResults baseline;
+    PerfResults results;
+
+    if (!PerfResults::load(arguments.at(0), baseline)) return Error;
+    if (!loadAll(arguments.mid(1), results)) return Error;
+
+    if (results.isEmpty()) {
+        qCritical("No result to compare");
+        return Error;
+    }
+
+    const double threshold = parser.value("threshold").toDouble() / 100;
+    const double noiseFactor = parser.value("noise").toDouble();
+    int regressions = 0;
+
+    QTextStream out(stdout);
+    out << "baseline: " << (baseline.label().isEmpty() ? "unlabeled" : baseline.label())
+        << ", " << baseline.date().toString(Qt::ISODate) << Qt::endl;
+    out << QString("%1 %2 %3 %4 %5  %6").arg("metric", -44).arg("baseline", 12).arg("new", 12)
+           .arg("change", 9).arg("allowed", 9).arg("status") << Qt::endl;
+
+    foreach (QString name , baseline.names()) {
+        const PerfResults::Metric before = baseline.metric(name);
+
+        if (!results.contains(name)) {
+            out << QString("%1 %2 %3").arg(name, -44).arg(median(before.values), 12, 'g', 6).arg("", 32) << "  missing" << Qt::endl;
+            continue;
+        }
+
+        const PerfResults::Metric after = results.metric(name);
+        const double base = median(before.values);
+        const double value = median(after.values);
+        const double allowed = std::max({ threshold * std::abs(base), noiseFactor * noise(before.values),
+                                          noiseFactor * noise(after.values), minimumChange(before.unit) });
+        const double change = value - base;
+
+        QString status = "ok";
+        if (change > allowed) {
+            status = "REGRESSION";
+            regressions++;
+        }
+        else if (change < -allowed) {
+            status = "improved";
+        }
+
+        auto percents = [base](double delta) {
+            return base != 0 ? QString("%1%").arg(100 * delta / base, 0, 'f', 1) : QString("-");
+        };
+
+        out << QString("%1 %2 %3 %4 %5").arg(name, -44).arg(base, 12, 'g', 6).arg(value, 12, 'g', 6)
+               .arg(percents(change), 9).arg(percents(allowed), 9)
+            << "  " << status << " (" << after.unit << ")" << Qt::endl;
+    }
+
+    foreach (QString name , results.names()) {
+        if (!baseline.contains(name)) out << QString("%1 %2").arg(name, -44).arg(median(results.metric(name).values), 25, 'g', 6) << "  new" << Qt::endl;
+    }
+
+    out << regressions << " regressions" << Qt::endl;
+
+    return regressions > 0 ? Regression : Success;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("perfbaseline");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Save the results of enginebench (SWIFTY_BENCH_RESULTS) and of the replay mode (--results) "
+                                     "as a baseline, and compare new results to it. "
+                                     "The exit code is 1 on a regression and 2 on an error.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("command", "save or compare.");
+    parser.addPositionalArgument("baseline", "The baseline file.");
+    parser.addPositionalArgument("results", "Result files, the values of several runs are merged.", "<results>...");
+    parser.addOptions({
+        { "label", "save: build of the baseline, like the output of git describe.", "label" },
+        { "append", "save: add the results to the runs of the baseline." },
+        { "threshold", "compare: allowed growth in percents, 10 by default.", "percents", "10" },
+        { "noise", "compare: allowed growth in times the noise of the runs, 3 by default.", "factor", "3" }
+    });
+    parser.process(app);
+
+    const QList<QString> arguments = parser.positionalArguments();
+    if (arguments.length() < 3) parser.showHelp(Error);
+
+    const QString command = arguments.first();
+    if (command == "save") return save(parser, arguments.mid(1));
+    if (command == "compare") return compare(parser, arguments.mid(1));
+
+    qCritical("Unknown command %s", qPrintable(command));
+    return Error;
+}
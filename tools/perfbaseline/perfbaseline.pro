@@ -0,0 +1,35 @@
+#   Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+#	
+#   Copyright (C) <2021>  <SwiftApp>
+#
+#   This program is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   This program is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+# Store of the performance baselines and comparison of new results, used to gate the builds of the engine:
+# qmake tools/perfbaseline/perfbaseline.pro && make && ./perfbaseline compare baseline.json results.json
+
+QT = core
+
+CONFIG += console
+CONFIG -= app_bundle
+
+TARGET = perfbaseline
+
+INCLUDEPATH += ../../src
+
+HEADERS += \
+    ../../src/perfresults.h
+
+SOURCES += \
+    main.cpp \
+    ../../src/perfresults.cpp
@@ -0,0 +1,200 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include "syntheticxml.h"
+
+#include <QRandomGenerator>
+#include <QXmlStreamWriter>
+
+/**
+ * Choose the items with a <Var> and a <condition>, the same spec always gives the same plugin
+ */
+SyntheticXml::SyntheticXml(const SyntheticSpec &spec) : spec(spec)
+{
+    QRandomGenerator generator(spec.seed + quint32(spec.plugin) * 7919u);
+
+    this->spec.groups = qMax(1, spec.groups);
+    this->spec.fanOut = qMax(1, spec.fanOut);
+
+    for (int i = 0; i < spec.items; i++) {
+        hasVar.append(generator.generateDouble() < spec.varDensity);
+        hasCondition.append(generator.generateDouble() < spec.conditionDensity);
+    }
+}
+
+QString SyntheticXml::xml() const
+{
+    QString xml;
+    QXmlStreamWriter writer(&xml);
+    writer.writeStartElement("Swifty");
+
+    for (int i = 0; i < spec.items; i++) {
+        writer.writeStartElement("Item");
+        writer.writeAttribute("id", itemId(i));
+        writer.writeAttribute("needId", childId(i));
+
+        writer.writeStartElement("Keywords");
+        writer.writeAttribute("minWord", QString::number(spec.groups));
+        writer.writeAttribute("maxWord", QString::number(spec.groups*2 + 6));
+
+        for (int group = 0; group < spec.groups; group++) {
+            writer.writeStartElement("Words");
+            for (int synonym = 0; synonym < spec.fanOut; synonym++)
+                writer.writeTextElement("word", keyword(i, group, synonym));
+            writer.writeEndElement();
+        }
+
+        writer.writeStartElement("NoWords");
+        writer.writeTextElement("word", "pas");
+        writer.writeEndElement();
+        writer.writeEndElement();
+
+        if (hasVar.at(i)) {
+            writer.writeStartElement("Var");
+            writer.writeAttribute("max", "3");
+            writer.writeTextElement("word", keyword(i, spec.groups-1, 0));
+            writer.writeEndElement();
+        }
+
+        writer.writeStartElement("Reply");
+
+        if (hasCondition.at(i)) {
+            writer.writeStartElement("condition");
+            writer.writeAttribute("if", hasVar.at(i) ? "?1=rouge vert" : "?0!inconnu");
+            writer.writeTextElement("rep", "Condition "+itemId(i)+" : ?0");
+            writer.writeEndElement();
+            writer.writeStartElement("else");
+            writer.writeTextElement("rep", "Sinon "+itemId(i));
+            writer.writeEndElement();
+        }
+        else {
+            writer.writeTextElement("rep", "Reponse "+itemId(i)+" pour ?1");
+            writer.writeTextElement("rep", "Autre reponse "+itemId(i)+" : ?0");
+        }
+
+        writer.writeEndElement();
+
+        writer.writeStartElement("Actions");
+        writer.writeTextElement("action", "synthetic run ?1");
+        writer.writeEndElement();
+
+        // The sub-item keeps the conversation on itself
+        writer.writeStartElement("Item");
+        writer.writeAttribute("id", childId(i));
+        writer.writeAttribute("needId", childId(i));
+        writer.writeStartElement("Keywords");
+        writer.writeAttribute("minWord", "1");
+        writer.writeAttribute("maxWord", "8");
+        writer.writeStartElement("Words");
+        writer.writeTextElement("word", keyword(i, spec.groups, 0));
+        writer.writeTextElement("word", "oui");
+        writer.writeEndElement();
+        writer.writeEndElement();
+        writer.writeStartElement("Reply");
+        writer.writeTextElement("rep", "Suite "+childId(i));
+        writer.writeEndElement();
+        writer.writeEndElement();
+
+        writer.writeEndElement();
+    }
+
+    writer.writeEndElement();
+
+    return xml;
+}
+
+/**
+ * @return the propositions returned by getCommande(), the commands of the first items
+ */
+QList<QString> SyntheticXml::commands() const
+{
+    QList<QString> commands;
+
+    for (int i = 0; i < spec.items && i < spec.commands; i++)
+        commands.append(command(i));
+
+    return commands;
+}
+
+QString SyntheticXml::pluginId() const
+{
+    return "fr.swifty.synthetic"+QString::number(spec.plugin);
+}
+
+/**
+ * @return a command matched by the item, followed by two words for its <Var>
+ */
+QString SyntheticXml::command(int item) const
+{
+    QList<QString> words;
+
+    for (int group = 0; group < spec.groups-1; group++) {
+        words.append(keyword(item, group, qMin(1, spec.fanOut-1)));
+        words.append("le");
+    }
+
+    words.append(keyword(item, spec.groups-1, 0));
+    words.append("rouge");
+    words.append("vert");
+
+    return words.join(" ");
+}
+
+/**
+ * @return a command matched by the sub-item of the item
+ */
+QString SyntheticXml::followUp(int item) const
+{
+    return "oui "+keyword(item, spec.groups, 0);
+}
+
+QString SyntheticXml::itemId(int item) const
+{
+    return "item"+QString::number(item);
+}
+
+QString SyntheticXml::childId(int item) const
+{
+    return "child"+QString::number(item);
+}
+
+/**
+ * Build a word from syllables, different for each number
+ */
+QString SyntheticXml::word(int n)
+{
+    static const char *syllables[] = { "ka", "lo", "mi", "ne", "ru", "sa", "to", "vi" };
+    QString result;
+
+    do {
+        result.append(syllables[n % 8]);
+        n /= 8;
+    } while (n > 0);
+
+    // At least three syllables, so the words are not corrected into each other
+    while (result.length() < 6) result.append("bu");
+
+    return result;
+}
+
+/**
+ * @param group the <Words> group, spec.groups for the keyword of the sub-item
+ */
+QString SyntheticXml::keyword(int item, int group, int synonym) const
+{
+    return word(((spec.plugin * spec.items + item) * (spec.groups+1) + group) * spec.fanOut + synonym);
+}
@@ -0,0 +1,72 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#ifndef SYNTHETICXML_H
+#define SYNTHETICXML_H
+
+#include <QList>
+#include <QString>
+#include <QVector>
+
+/**
+ * The size of a generated plugin
+ */
+struct SyntheticSpec
+{
+    int plugin = 0;
+    int items = 100;
+    int groups = 2;
+    int fanOut = 3;
+    double varDensity = 0.5;
+    double conditionDensity = 0.2;
+    int commands = 20;
+    quint32 seed = 1;
+};
+
+/**
+ * Generate the xml of a plugin, used to test the engine with many plugins and items.
+ *
+ * Each item has `groups` <Words> of `fanOut` keywords, a <Var> and a <condition>
+ * for a part of the items, a reply, an action and a sub-item continuing the
+ * conversation. The words are made of syllables and are different for each
+ * plugin and each item, so a command is matched by one item only.
+ */
+class SyntheticXml
+{
+public:
+    explicit SyntheticXml(const SyntheticSpec &spec);
+
+    QString xml() const;
+    QList<QString> commands() const;
+    QString pluginId() const;
+
+    QString command(int item) const;
+    QString followUp(int item) const;
+    QString itemId(int item) const;
+    QString childId(int item) const;
+
+    static QString word(int n);
+
+private:
+    QString keyword(int item, int group, int synonym) const;
+
+    SyntheticSpec spec;
+    QVector<bool> hasVar;
+    QVector<bool> hasCondition;
+};
+
+#endif // SYNTHETICXML_H
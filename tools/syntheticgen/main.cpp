@@ -0,0 +1,139 @@
+/* Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+
+   Copyright (C) <2021>  <SwiftApp>
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>. */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <QSaveFile>
+#include <QFile>
+#include <QDir>
+
+#include "syntheticxml.h"
+
+/**
+ * Write a file, replacing the old one only if it is complete
+ */
+static bool writeFile(const QString &path, const QByteArray &data)
+{
+    QSaveFile file(path);
+
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        qCritical("Cannot write %s", qPrintable(path));
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Generate the commands sent to the assistant, for --batch or the replay of a recording:
+ * commands of the items, follow-ups of the conversation and unknown sentences
+ */
+static QList<QString> utterances(const QList<SyntheticXml> &plugins, const SyntheticSpec &spec, int count)
+{
+    QRandomGenerator generator(spec.seed);
+    QList<QString> lines;
+
+    for (int i = 0; i < count && !plugins.isEmpty() && spec.items > 0; i++) {
+        const SyntheticXml &plugin = plugins.at(generator.bounded(plugins.length()));
+        int item = generator.bounded(spec.items);
+        double kind = generator.generateDouble();
+
+        if (kind < 0.7) lines.append(plugin.command(item));
+        else if (kind < 0.8) lines.append(plugin.followUp(item));
+        else lines.append(SyntheticXml::word(generator.bounded(1 << 20))+" "+SyntheticXml::word(generator.bounded(1 << 20)));
+    }
+
+    return lines;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("syntheticgen");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Generate the xml of synthetic plugins for the generated plugin of tools/generatedplugin");
+    parser.addHelpOption();
+    parser.addOptions({
+        { "output", "Directory of the plugins, ~/SwiftyPlugins by default.", "dir" },
+        { "library", "Build of tools/generatedplugin copied to synthetic_<n>.sw for each plugin.", "file" },
+        { "plugins", "Number of plugins, 10 by default.", "n", "10" },
+        { "items", "Number of <Item> of each plugin, 100 by default.", "n", "100" },
+        { "groups", "Number of <Words> of each item, 2 by default.", "n", "2" },
+        { "fanout", "Number of keywords of each <Words>, 3 by default.", "n", "3" },
+        { "vars", "Part of the items with a <Var>, 0.5 by default.", "ratio", "0.5" },
+        { "conditions", "Part of the items with a <condition>, 0.2 by default.", "ratio", "0.2" },
+        { "commands", "Number of propositions returned by getCommande(), 20 by default.", "n", "20" },
+        { "utterances", "Number of commands written to synthetic_utterances.txt, 1000 by default.", "n", "1000" },
+        { "seed", "Seed of the generator, 1 by default.", "n", "1" }
+    });
+    parser.process(app);
+
+    QString output = parser.isSet("output") ? parser.value("output") : QDir::homePath()+"/SwiftyPlugins";
+    if (!QDir().mkpath(output)) {
+        qCritical("Cannot create %s", qPrintable(output));
+        return 1;
+    }
+
+    QDir dir(output);
+    QString library = parser.value("library");
+    if (!library.isEmpty() && !QFile::exists(library)) {
+        qCritical("%s does not exist", qPrintable(library));
+        return 1;
+    }
+
+    SyntheticSpec spec;
+    spec.items = parser.value("items").toInt();
+    spec.groups = parser.value("groups").toInt();
+    spec.fanOut = parser.value("fanout").toInt();
+    spec.varDensity = parser.value("vars").toDouble();
+    spec.conditionDensity = parser.value("conditions").toDouble();
+    spec.commands = parser.value("commands").toInt();
+    spec.seed = parser.value("seed").toUInt();
+
+    int count = parser.value("plugins").toInt();
+    QList<SyntheticXml> plugins;
+
+    for (int i = 0; i < count; i++) {
+        spec.plugin = i;
+        SyntheticXml plugin(spec);
+        QString name = "synthetic_"+QString::number(i);
+
+        if (!writeFile(dir.filePath(name+".xml"), plugin.xml().toUtf8())) return 1;
+        if (!writeFile(dir.filePath(name+".commands"), plugin.commands().join("\n").toUtf8()+"\n")) return 1;
+
+        if (!library.isEmpty()) {
+            QFile::remove(dir.filePath(name+".sw"));
+            if (!QFile::copy(library, dir.filePath(name+".sw"))) {
+                qCritical("Cannot copy %s", qPrintable(library));
+                return 1;
+            }
+        }
+
+        plugins.append(plugin);
+    }
+
+    spec.plugin = 0;
+    QList<QString> lines = utterances(plugins, spec, parser.value("utterances").toInt());
+    if (!writeFile(dir.filePath("synthetic_utterances.txt"), lines.join("\n").toUtf8()+"\n")) return 1;
+
+    QTextStream(stdout) << count << " plugins of " << spec.items << " items written to " << dir.absolutePath() << Qt::endl;
+
+    return 0;
+}
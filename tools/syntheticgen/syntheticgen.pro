@@ -0,0 +1,35 @@
+#   Swifty Assistant is a simple, user-friendly assistant based on an extension system.
+#	
+#   Copyright (C) <2021>  <SwiftApp>
+#
+#   This program is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   This program is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+# Generator of synthetic plugins, used to test the assistant at 10x or 100x the size of the real plugins:
+# qmake tools/syntheticgen/syntheticgen.pro && make && ./syntheticgen --plugins 100 --library libgeneratedplugin.so
+
+QT = core
+
+CONFIG += console
+CONFIG -= app_bundle
+
+TARGET = syntheticgen
+
+INCLUDEPATH += ../synthetic
+
+HEADERS += \
+    ../synthetic/syntheticxml.h
+
+SOURCES += \
+    main.cpp \
+    ../synthetic/syntheticxml.cpp